@@ -0,0 +1,106 @@
+#include "stdafx.h"
+#include "nArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+using namespace nNetwork;
+
+nArena::nArena(size_t blockSize)
+	: m_pBlocks{ nullptr }
+	, m_pCurrent{ nullptr }
+	, m_pEnd{ nullptr }
+	, m_blockSize{ blockSize }
+	, m_used{ 0 }
+	, m_capacity{ 0 }
+	, m_blockCount{ 0 }
+{
+}
+
+nArena::~nArena()
+{
+	Release();
+}
+
+void* nArena::Allocate(size_t size, size_t alignment)
+{
+	lock_guard<mutex> lock{ m_lock };
+
+	uintptr_t current = (uintptr_t)m_pCurrent;
+	uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+	if (!m_pCurrent || aligned + size > (uintptr_t)m_pEnd) {
+		AddBlock(size + alignment);
+		current = (uintptr_t)m_pCurrent;
+		aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+
+	m_pCurrent = (char*)(aligned + size);
+	m_used += size;
+
+	return (void*)aligned;
+}
+
+void nArena::Reserve(size_t size)
+{
+	lock_guard<mutex> lock{ m_lock };
+
+	if (!m_pCurrent || (size_t)(m_pEnd - m_pCurrent) < size)
+		AddBlock(size);
+}
+
+void nArena::AddBlock(size_t size)
+	// The block header sits in front of the block, padded to the strictest fundamental
+	// alignment. A new block is never smaller than the last one.
+{
+	size = max(size, m_blockSize);
+	m_blockSize = size;
+
+	const size_t header = (sizeof(nBlock) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+
+	nBlock* pBlock = static_cast<nBlock*>(::operator new(header + size));
+	pBlock->pNext = m_pBlocks;
+	m_pBlocks = pBlock;
+
+	m_pCurrent = (char*)pBlock + header;
+	m_pEnd     = m_pCurrent + size;
+
+	m_capacity += size;
+	++m_blockCount;
+}
+
+void nArena::Release()
+{
+	lock_guard<mutex> lock{ m_lock };
+
+	while (m_pBlocks) {
+		nBlock* pNext = m_pBlocks->pNext;
+		::operator delete(m_pBlocks);
+		m_pBlocks = pNext;
+	}
+
+	m_pCurrent   = nullptr;
+	m_pEnd       = nullptr;
+	m_used       = 0;
+	m_capacity   = 0;
+	m_blockCount = 0;
+}
+
+size_t nArena::GetUsedSize() const
+{
+	lock_guard<mutex> lock{ m_lock };
+	return m_used;
+}
+
+size_t nArena::GetCapacity() const
+{
+	lock_guard<mutex> lock{ m_lock };
+	return m_capacity;
+}
+
+int nArena::GetBlockCount() const
+{
+	lock_guard<mutex> lock{ m_lock };
+	return m_blockCount;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+namespace nNetwork {
+
+	//++ nArena
+	//
+	//+ Purpose:
+	//		Monotonic memory resource for the node and synapse arrays of networks.
+	//
+	//+ Remarks:
+	//		Allocation bumps a pointer through the current block. When the block is full a new
+	//		one is taken from operator new, at least as large as the previous one. Deallocation
+	//		does nothing, every block is freed at once by Release or by the destructor, so a
+	//		network built in an arena is torn down without a free per array.
+	//		Networks Reserve what they need before they allocate, so a network built in an arena
+	//		of its own normally occupies a single block. Allocate and Reserve are serialised, an
+	//		arena can be shared by networks built on several threads.
+	class nArena {
+	public:
+		// Blocks are at least blockSize bytes. No memory is taken until the first allocation.
+		explicit nArena(size_t blockSize = 64 * 1024);
+		~nArena();
+
+		nArena(const nArena&) = delete;
+		nArena& operator=(const nArena&) = delete;
+
+		// size bytes aligned to alignment, which must be a power of 2.
+		void* Allocate(size_t size, size_t alignment);
+
+		// Make sure that the next size bytes of allocations fit in the current block.
+		void Reserve(size_t size);
+
+		// Free every block. Everything allocated from the arena becomes invalid.
+		void Release();
+
+		size_t GetUsedSize()   const;
+		size_t GetCapacity()   const;
+		int    GetBlockCount() const;
+
+	private:
+		struct nBlock {
+			nBlock* pNext;
+		};
+
+		mutable std::mutex m_lock;
+
+		nBlock* m_pBlocks;
+		char*   m_pCurrent;
+		char*   m_pEnd;
+
+		size_t m_blockSize;
+		size_t m_used;
+		size_t m_capacity;
+		int    m_blockCount;
+
+		// Start a new block with at least size bytes free. m_lock must be held.
+		void AddBlock(size_t size);
+	};
+
+	//++ nArenaAllocator
+	//
+	//+ Purpose:
+	//		Standard allocator that takes memory from an nArena, or from the heap when it has no
+	//		arena.
+	//
+	//+ Remarks:
+	//		Copying a container gives the copy a heap allocator, since the copy may outlive the
+	//		arena. Assignment keeps the arena of the destination.
+	template <class T>
+	class nArenaAllocator {
+	public:
+		using value_type = T;
+
+		nArenaAllocator() : m_pArena{ nullptr } {}
+		nArenaAllocator(nArena* pArena) : m_pArena{ pArena } {}
+
+		template <class U>
+		nArenaAllocator(const nArenaAllocator<U>& other) : m_pArena{ other.GetArena() } {}
+
+		T* allocate(size_t count) {
+			if (m_pArena)
+				return static_cast<T*>(m_pArena->Allocate(count * sizeof(T), alignof(T)));
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+
+		void deallocate(T* p, size_t) {
+			if (!m_pArena)
+				::operator delete(p);
+		}
+
+		nArenaAllocator select_on_container_copy_construction() const { return nArenaAllocator{}; }
+
+		nArena* GetArena() const { return m_pArena; }
+
+		template <class U>
+		friend bool operator==(const nArenaAllocator& left, const nArenaAllocator<U>& right) { return left.GetArena() == right.GetArena(); }
+		template <class U>
+		friend bool operator!=(const nArenaAllocator& left, const nArenaAllocator<U>& right) { return left.GetArena() != right.GetArena(); }
+
+	private:
+		nArena* m_pArena;
+	};
+
+	template <class T>
+	using nArenaVector = std::vector<T, nArenaAllocator<T>>;
+}
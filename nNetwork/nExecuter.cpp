@@ -1,5 +1,7 @@
 #include "nNetwork.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace nNetwork {
@@ -7,18 +9,35 @@ namespace nNetwork {
 	nExecuter::nExecuter(const vector<int>& layerCounts, const ISensor& sensor) 
 	{
 		m_pNetwork = make_unique<nNodeNetwork>(layerCounts, sensor);
-		m_pThread = make_unique<thread>(nExecuter::ThreadExecuter, m_pNetwork.get(), &m_executerContext);
+		Launch();
 	}
 
 	nExecuter::nExecuter(const vector<int>& layerCounts, const ISensor& sensor, nNodeNetworkConfig config) 
 	{
 		m_pNetwork = make_unique<nNodeNetwork>(layerCounts, sensor, config);
+		Launch();
+	}
+
+	nExecuter::nExecuter(unique_ptr<nNodeNetwork> pNetwork, int currentIteration)
+	{
+		m_pNetwork = move(pNetwork);
+		m_executerContext.CurrentIteration.store(currentIteration);
+		Launch();
+	}
+
+	void nExecuter::Launch()
+		// Publish the initial state, so GetSnapShot works before the first tick, and start the
+		// executer thread, paused.
+	{
+		m_executerContext.SnapShotInterval = max(1, m_pNetwork->GetConfig().SnapShotInterval);
+		m_executerContext.Publish(*m_pNetwork);
+
 		m_pThread = make_unique<thread>(nExecuter::ThreadExecuter, m_pNetwork.get(), &m_executerContext);
 	}
 
 	nExecuter::~nExecuter()
 	{
-		if (!m_executerContext.ExitToken) {
+		if (!m_executerContext.ExitToken.load(memory_order_acquire)) {
 			Exit();
 		}
 		if (m_pThread->joinable())
@@ -27,42 +46,123 @@ namespace nNetwork {
 
 	void nExecuter::Start()
 	{
-		m_executerContext.PauseToken = 0;
+		SetToken(m_executerContext.PauseToken, 0);
 	}
 
 	void nExecuter::Pause()
 	{
-		m_executerContext.PauseToken = 1;
+		// The executer notices on its next tick, there is nobody to wake.
+		m_executerContext.PauseToken.store(1, memory_order_release);
 	}
 
 	void nExecuter::Exit()
 	{
-		m_executerContext.ExitToken = 1;
+		SetToken(m_executerContext.ExitToken, 1);
 	}
 
+	void nExecuter::SetToken(atomic<int>& token, int value)
+		// Write a token that may have to wake a parked executer. Writing under ParkLock means the
+		// executer either sees the new value before it blocks or is already blocked and notified.
+	{
+		{
+			lock_guard<mutex> park { m_executerContext.ParkLock };
+			token.store(value, memory_order_release);
+		}
+		m_executerContext.Wake.notify_one();
+	}
 
 	int nExecuter::GetCurrentIterations() const
 	{
-		return m_executerContext.CurrentIteration;
+		return m_executerContext.CurrentIteration.load(memory_order_acquire);
 	}
 
 	unique_ptr<nNodeNetwork> nExecuter::GetSnapShot() const
+		// Copy the most recently published state. This never waits for the executer thread,
+		// the result may be up to SnapShotInterval ticks old.
+	{
+		return m_executerContext.GetSnapShot(*m_pNetwork);
+	}
+
+	void nExecuter::GetState(nNetworkState& state) const
 	{
-		lock_guard<mutex> lock { m_executerContext.Lock };
-		return m_pNetwork->GetSnapShot();
+		m_executerContext.GetState(state);
+	}
+
+	nNetworkImage nExecuter::GetImage(nNetworkState& state, vector<int>& layerCounts) const
+	{
+		GetState(state);
+		return m_pNetwork->GetImage(layerCounts, state);
 	}
 
 	void nExecuter::ThreadExecuter(nNodeNetwork *pNetwork, nExecuterContext *pContext)
 	{
 		while (1)
 		{
-			if (pContext->ExitToken) return;
+			if (pContext->ExitToken.load(memory_order_acquire)) return;
+
+			if (pContext->PauseToken.load(memory_order_acquire)) {
+				// Readers of a paused executer see its exact state.
+				pContext->PublishPending(*pNetwork);
 
-			if (pContext->PauseToken) continue;
-			
-			lock_guard<mutex> lock { pContext->Lock };
-			pNetwork->Tick();
-			++pContext->CurrentIteration;
+				unique_lock<mutex> park { pContext->ParkLock };
+				pContext->Wake.wait(park, [pContext] {
+					return !pContext->PauseToken.load(memory_order_acquire) || pContext->ExitToken.load(memory_order_acquire);
+				});
+				continue;
+			}
+
+			pContext->Tick(*pNetwork);
 		}
 	}
-}
\ No newline at end of file
+
+	/*---------------------------------------------------------------------------------------------
+		nExecuterContext
+	---------------------------------------------------------------------------------------------*/
+
+	void nExecuterContext::Tick(nNodeNetwork& network)
+	{
+		network.Tick();
+		int iteration = CurrentIteration.fetch_add(1, memory_order_release) + 1;
+
+		if (iteration - Published >= SnapShotInterval)
+			Publish(network);
+	}
+
+	void nExecuterContext::Publish(const nNodeNetwork& network)
+	{
+		nNetworkState& state = SnapShots.GetBack();
+
+		network.GetState(state);
+		state.Iteration = CurrentIteration.load(memory_order_relaxed);
+		Published       = state.Iteration;
+
+		SnapShots.Publish();
+	}
+
+	void nExecuterContext::PublishPending(const nNodeNetwork& network)
+	{
+		if (Published != CurrentIteration.load(memory_order_relaxed))
+			Publish(network);
+	}
+
+	void nExecuterContext::GetState(nNetworkState& state) const
+	{
+		lock_guard<mutex> lock { Lock };
+
+		SnapShots.Acquire();
+
+		const nNetworkState& front = SnapShots.GetFront();
+		state.CurrentValues.assign(front.CurrentValues.begin(), front.CurrentValues.end());
+		state.RestCounts.assign(front.RestCounts.begin(), front.RestCounts.end());
+		state.Spikes.assign(front.Spikes.begin(), front.Spikes.end());
+		state.Iteration = front.Iteration;
+	}
+
+	unique_ptr<nNodeNetwork> nExecuterContext::GetSnapShot(const nNodeNetwork& network) const
+	{
+		lock_guard<mutex> lock { Lock };
+
+		SnapShots.Acquire();
+		return network.GetSnapShot(SnapShots.GetFront());
+	}
+}
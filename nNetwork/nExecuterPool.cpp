@@ -0,0 +1,152 @@
+#include "stdafx.h"
+#include "nExecuterPool.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace nNetwork;
+
+/*-------------------------------------------------------------------------------------------------
+	nPooledExecuter
+-------------------------------------------------------------------------------------------------*/
+
+nPooledExecuter::nPooledExecuter(nExecuterPool& pool, unique_ptr<nNodeNetwork> pNetwork, int weight)
+	: m_pool{ pool }
+	, m_pNetwork{ move(pNetwork) }
+	, m_weight{ weight }
+{
+	m_executerContext.SnapShotInterval = max(1, m_pNetwork->GetConfig().SnapShotInterval);
+	m_executerContext.Publish(*m_pNetwork);
+}
+
+void nPooledExecuter::Start()
+{
+	m_executerContext.PauseToken.store(0, memory_order_release);
+	m_pool.Schedule(*this);
+}
+
+void nPooledExecuter::Pause()
+	// The worker running the executer notices on its next tick and drops it from the run queue.
+{
+	m_executerContext.PauseToken.store(1, memory_order_release);
+}
+
+void nPooledExecuter::Exit()
+{
+	m_executerContext.ExitToken.store(1, memory_order_release);
+}
+
+int nPooledExecuter::GetCurrentIterations() const
+{
+	return m_executerContext.CurrentIteration.load(memory_order_acquire);
+}
+
+unique_ptr<nNodeNetwork> nPooledExecuter::GetSnapShot() const
+{
+	return m_executerContext.GetSnapShot(*m_pNetwork);
+}
+
+void nPooledExecuter::GetState(nNetworkState& state) const
+{
+	m_executerContext.GetState(state);
+}
+
+/*-------------------------------------------------------------------------------------------------
+	nExecuterPool
+-------------------------------------------------------------------------------------------------*/
+
+nExecuterPool::nExecuterPool(int threadCount, int quantum)
+	: m_quantum{ max(1, quantum) }
+{
+	if (threadCount <= 0)
+		threadCount = max(1, (int)thread::hardware_concurrency());
+
+	for (int x = 0; x < threadCount; ++x)
+		m_workers.emplace_back(&nExecuterPool::Worker, this);
+}
+
+nExecuterPool::~nExecuterPool()
+{
+	{
+		lock_guard<mutex> lock{ m_lock };
+		m_exit = true;
+	}
+	m_wake.notify_all();
+
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+nPooledExecuter& nExecuterPool::Add(unique_ptr<nNodeNetwork> pNetwork, int weight)
+{
+	if (weight < 1)
+		throw "The weight of a pooled executer must be at least 1.";
+
+	unique_ptr<nPooledExecuter> pExecuter{ new nPooledExecuter(*this, move(pNetwork), weight) };
+
+	lock_guard<mutex> lock{ m_lock };
+	m_executers.push_back(move(pExecuter));
+	return *m_executers.back();
+}
+
+int nExecuterPool::GetExecuterCount() const
+{
+	lock_guard<mutex> lock{ m_lock };
+	return (int)m_executers.size();
+}
+
+void nExecuterPool::Schedule(nPooledExecuter& executer)
+	// Queue a started executer unless it is already queued or running. A worker that is running
+	// it checks the tokens under the same lock before dropping it, so a Start that races with
+	// a Pause is never lost.
+{
+	{
+		lock_guard<mutex> lock{ m_lock };
+		if (executer.m_scheduled || executer.m_executerContext.ExitToken.load(memory_order_acquire))
+			return;
+		executer.m_scheduled = true;
+		m_runQueue.push_back(&executer);
+	}
+	m_wake.notify_one();
+}
+
+void nExecuterPool::Worker()
+{
+	unique_lock<mutex> lock{ m_lock };
+
+	while (true) {
+		m_wake.wait(lock, [this] { return m_exit || !m_runQueue.empty(); });
+		if (m_exit)
+			return;
+
+		nPooledExecuter* pExecuter = m_runQueue.front();
+		m_runQueue.pop_front();
+		lock.unlock();
+
+		nExecuterContext& context = pExecuter->m_executerContext;
+		nNodeNetwork&     network = *pExecuter->m_pNetwork;
+
+		int ticks = pExecuter->m_weight * m_quantum;
+		for (int x = 0; x < ticks; ++x) {
+			if (context.ExitToken.load(memory_order_acquire) || context.PauseToken.load(memory_order_acquire))
+				break;
+			context.Tick(network);
+		}
+
+		// Readers of a paused executer see its exact state. This has to happen before the
+		// executer is released, another worker may pick it up as soon as it is. The drop is
+		// decided under the lock, so the pause is checked there and the state published with
+		// the lock released. Start never requeues an executer that is still m_scheduled, so no
+		// other worker ticks it meanwhile, and no tick happens after the publication.
+		lock.lock();
+		while (context.PauseToken.load(memory_order_acquire) && context.Published != context.CurrentIteration.load(memory_order_relaxed)) {
+			lock.unlock();
+			context.PublishPending(network);
+			lock.lock();
+		}
+		if (context.ExitToken.load(memory_order_acquire) || context.PauseToken.load(memory_order_acquire))
+			pExecuter->m_scheduled = false;
+		else
+			m_runQueue.push_back(pExecuter);
+	}
+}
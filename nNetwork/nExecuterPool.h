@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "nNetwork.h"
+
+namespace nNetwork {
+
+	class nExecuterPool;
+
+	//++ nPooledExecuter
+	//
+	//+ Purpose:
+	//		A network executed by an nExecuterPool. Same controls and readers as nExecuter.
+	//
+	//+ Remarks:
+	//		Owned by the pool, valid for the lifetime of the pool. A new pooled executer is
+	//		paused; an exited one never runs again.
+	class nPooledExecuter
+	{
+		friend class nExecuterPool;
+	public:
+		void Start();
+		void Pause();
+		void Exit();
+
+		int GetCurrentIterations() const;
+		int GetWeight() const { return m_weight; }
+
+		std::unique_ptr<nNodeNetwork> GetSnapShot() const;
+		void GetState(nNetworkState& state) const;
+
+	private:
+		nPooledExecuter(nExecuterPool& pool, std::unique_ptr<nNodeNetwork> pNetwork, int weight);
+
+		nExecuterPool&                m_pool;
+		std::unique_ptr<nNodeNetwork> m_pNetwork;
+		nExecuterContext              m_executerContext;
+		int                           m_weight;
+
+		// True while the executer is in the run queue or being ticked, guarded by the pool lock.
+		bool                          m_scheduled{ false };
+	};
+
+	//++ nExecuterPool
+	//
+	//+ Purpose:
+	//		Executes many networks on a fixed set of worker threads.
+	//
+	//+ Remarks:
+	//		Running executers wait in a FIFO run queue. A worker takes the executer at the front,
+	//		ticks it for weight * quantum ticks (less when it is paused or exited meanwhile) and
+	//		puts it back at the end, so every running executer gets CPU time in proportion to its
+	//		weight. An executer is only ever ticked by one worker at a time. The pool lock is taken
+	//		once per turn, not per tick, and idle workers sleep.
+	class nExecuterPool
+	{
+		friend class nPooledExecuter;
+	public:
+		// threadCount 0 uses every hardware thread. quantum is the number of ticks per turn for
+		// a weight of 1.
+		explicit nExecuterPool(int threadCount = 0, int quantum = 64);
+		~nExecuterPool();
+
+		nExecuterPool(const nExecuterPool&) = delete;
+		nExecuterPool& operator=(const nExecuterPool&) = delete;
+
+		// Add a network, paused. weight must be at least 1.
+		nPooledExecuter& Add(std::unique_ptr<nNodeNetwork> pNetwork, int weight = 1);
+
+		int GetThreadCount()   const { return (int)m_workers.size(); }
+		int GetExecuterCount() const;
+
+	private:
+		int m_quantum;
+
+		mutable std::mutex                            m_lock;
+		std::condition_variable                       m_wake;
+		bool                                          m_exit{ false };
+		std::deque<nPooledExecuter*>                  m_runQueue;
+		std::vector<std::unique_ptr<nPooledExecuter>> m_executers;
+		std::vector<std::thread>                      m_workers;
+
+		void Schedule(nPooledExecuter& executer);
+		void Worker();
+	};
+}
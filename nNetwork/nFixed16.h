@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nNetwork {
+
+	//++ nFixed16
+	//
+	//+ Purpose:
+	//		16 bit signed fixed point value with 14 fraction bits, a node value type for
+	//		nBasicNodeNetwork that takes a quarter of the memory of a double.
+	//
+	//+ Remarks:
+	//		The range is [-2, 2 - 2^-14] with a resolution of 2^-14. Arithmetic saturates at the
+	//		ends of the range instead of wrapping, so a node value plus a weight always lands at or
+	//		above the 1.0 that ActivateFromSynapse clips it to, exactly as it does for double.
+	//		Conversion from double rounds to the nearest step and saturates.
+	class nFixed16 {
+	public:
+		static const int     FRACTION_BITS = 14;
+		static const int32_t ONE           = 1 << FRACTION_BITS;
+		static const int32_t MAX_RAW       = INT16_MAX;
+		static const int32_t MIN_RAW       = INT16_MIN;
+
+		constexpr nFixed16() : m_raw{ 0 } {}
+		constexpr nFixed16(double value) : m_raw{ FromDouble(value) } {}
+
+		static nFixed16 FromRaw(int16_t raw) { nFixed16 value; value.m_raw = raw; return value; }
+		int16_t GetRaw() const { return m_raw; }
+
+		explicit constexpr operator double() const { return (double)m_raw / ONE; }
+		explicit constexpr operator float()  const { return (float)m_raw / ONE; }
+
+		nFixed16& operator+=(nFixed16 other) { m_raw = Saturate((int32_t)m_raw + other.m_raw); return *this; }
+		nFixed16& operator-=(nFixed16 other) { m_raw = Saturate((int32_t)m_raw - other.m_raw); return *this; }
+
+		friend nFixed16 operator+(nFixed16 left, nFixed16 right) { return left += right; }
+		friend nFixed16 operator-(nFixed16 left, nFixed16 right) { return left -= right; }
+
+		friend bool operator==(nFixed16 left, nFixed16 right) { return left.m_raw == right.m_raw; }
+		friend bool operator!=(nFixed16 left, nFixed16 right) { return left.m_raw != right.m_raw; }
+		friend bool operator< (nFixed16 left, nFixed16 right) { return left.m_raw <  right.m_raw; }
+		friend bool operator> (nFixed16 left, nFixed16 right) { return left.m_raw >  right.m_raw; }
+		friend bool operator<=(nFixed16 left, nFixed16 right) { return left.m_raw <= right.m_raw; }
+		friend bool operator>=(nFixed16 left, nFixed16 right) { return left.m_raw >= right.m_raw; }
+
+	private:
+		int16_t m_raw;
+
+		static constexpr int16_t Saturate(int32_t raw) {
+			return (int16_t)(raw > MAX_RAW ? MAX_RAW : raw < MIN_RAW ? MIN_RAW : raw);
+		}
+
+		static constexpr int16_t FromDouble(double value) {
+			return value * ONE >= MAX_RAW ? (int16_t)MAX_RAW
+				: value * ONE <= MIN_RAW ? (int16_t)MIN_RAW
+				: (int16_t)(value * ONE + (value < 0 ? -0.5 : 0.5));
+		}
+	};
+}
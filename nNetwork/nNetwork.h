@@ -6,11 +6,22 @@
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+
+#include "nArena.h"
+#include "nFixed16.h"
+#include "nRandom.h"
+#include "nTickMetrics.h"
+#include "nTripleBuffer.h"
 
 #define __DEBUG__
 
-// Define the base type of the node values, weight values, etc.
-// Should only ever be float or double.
+// Define the base type of the node values, weight values, etc. used by nNodeNetwork, the
+// sensors and the config. The network itself is a template on its value type, see
+// nBasicNodeNetwork.
 using vType = double;
 
 // The value that nNode::m_currentValue must reach for the node to fire.
@@ -20,13 +31,16 @@ const vType NODE_TRIGGER_POINT = 0.95;
 
 namespace nNetwork {
 
-	// Forward declarations
-	class nNode;
-
 	//++ ISensable
 	//
 	//+ Purpose:
 	//		An object that presents data to a sensor.
+	//
+	//+ Remarks:
+	//		Dimensions are numbered from 1. A location can also be expressed as a linear offset
+	//		into the sensable's data, by default the data is row major with dimension 1 varying
+	//		fastest. Sensables with a different layout override GetLinearOffset and SenseBatch
+	//		together.
 	template<typename T> class ISensable {
 	public:
 		virtual ~ISensable() {};
@@ -35,6 +49,32 @@ namespace nNetwork {
 		virtual int GetDimensionLength(int dimensionNumber) const = 0;
 
 		virtual T Sense(const std::vector<int>& location) const = 0;
+
+		virtual int GetLinearOffset(const std::vector<int>& location) const {
+			int offset = 0;
+			int stride = 1;
+			for (int x = 0; x < (int)location.size(); ++x) {
+				offset += location[x] * stride;
+				stride *= GetDimensionLength(x + 1);
+			}
+			return offset;
+		}
+
+		// Sense count locations at once, pResults[x] receives the value at linear offset
+		// pOffsets[x]. Implementations should override this to avoid a virtual call per
+		// location.
+		virtual void SenseBatch(const int* pOffsets, int count, T* pResults) const {
+			std::vector<int> location(GetDimensionCount());
+			for (int x = 0; x < count; ++x) {
+				int offset = pOffsets[x];
+				for (int d = 0; d < (int)location.size(); ++d) {
+					int length = GetDimensionLength(d + 1);
+					location[d] = offset % length;
+					offset /= length;
+				}
+				pResults[x] = Sense(location);
+			}
+		}
 	};
 
 	//++ ISensor
@@ -49,84 +89,282 @@ namespace nNetwork {
 	public:
 		virtual ~ISensor() {};
 		virtual vType Sense(const std::vector<int>& senseLocation) const = 0;
+
+		// Map a sense location to the linear offset understood by SenseBatch, or -1 when the
+		// sensor has no linear layout. nNodeNetwork calls this once per sensing node, when the
+		// network is built, and senses the nodes mapped to -1 through Sense.
+		virtual int GetLinearOffset(const std::vector<int>&) const { return -1; }
+
+		// Sense count nodes in one call, pResults[x] receives the normalised value at linear
+		// offset pOffsets[x]. Sensors that override GetLinearOffset override this too, it is
+		// never called with offsets the sensor did not hand out.
+		virtual void SenseBatch(const int*, int, vType*) const {
+			throw "The sensor does not support batched sensing.";
+		}
+	};
+
+	template <class V> class nBasicNodeNetwork;
+	class nThreadPool;
+
+	//++ nBasicSynapse
+	//
+	//+ Remarks:
+	//		target is the network id of the node on the receiving end of the synapse.
+	template <class V>
+	struct nBasicSynapse {
+		V   weight;
+		int target;
 	};
 
-	//++ nSynapse
-	struct nSynapse {
-		vType weight;
-		nNode *pNode;
+	//++ nBasicSynapseStore
+	//
+	//+ Purpose:
+	//		Compressed sparse row (CSR) storage for every synapse in a network.
+	//
+	//+ Remarks:
+	//		The outgoing synapses of the node with network id n occupy the range
+	//		[RowOffsets[n], RowOffsets[n + 1]) of the parallel Targets and Weights arrays, so
+	//		delivering a spike is a contiguous scan over both arrays. The arrays are allocated
+	//		from pArena when there is one, and are empty until the network builds them.
+	template <class V>
+	struct nBasicSynapseStore {
+		nBasicSynapseStore() : nBasicSynapseStore(nullptr) {}
+		explicit nBasicSynapseStore(nArena* pArena) : RowOffsets(pArena), Targets(pArena), Weights(pArena) {}
+
+		nArenaVector<int> RowOffsets;
+		nArenaVector<int> Targets;
+		nArenaVector<V>   Weights;
+
+		int GetSynapseCount()           const { return (int)Targets.size(); }
+		int GetRowBegin(int networkId)  const { return RowOffsets[networkId]; }
+		int GetRowEnd(int networkId)    const { return RowOffsets[networkId + 1]; }
 	};
 
-	//++ nNode
+	//++ nBasicSynapseView
 	//
 	//+ Purpose:
-	//		Represents a normal neuron. Sensing nodes are derived from nNode
-	class nNode {
-		friend class nSensingNode;
+	//		Read-only view of the outgoing synapses of a single node.
+	template <class V>
+	class nBasicSynapseView {
 	public:
-		nNode(int networkId);
-		nNode(int networkId, vType decay) : nNode{ networkId } { m_decay = decay; }
-		nNode(int networkId, vType decay, int maxRestCount) : nNode{ networkId, decay } { m_maxRestCount = maxRestCount; }
-		virtual ~nNode();
+		nBasicSynapseView(const int* pTargets, const V* pWeights, int count)
+			: m_pTargets{ pTargets }, m_pWeights{ pWeights }, m_count{ count } {}
 
-		std::vector<nSynapse> Synapses;
+		size_t           size() const { return (size_t)m_count; }
+		nBasicSynapse<V> operator[](size_t index) const { return nBasicSynapse<V>{ m_pWeights[index], m_pTargets[index] }; }
 
-		int   GetNetworkId()    const { return m_networkId; }
-		int   GetGlobalId()     const { return m_globalId; }
-		vType GetCurrentValue() const { return m_currentValue; }
-		void  SetCurrentValue(vType value) { m_currentValue = value; }
-		
+	private:
+		const int* m_pTargets;
+		const V*   m_pWeights;
+		int        m_count;
+	};
 
-		void Tick();
+	//++ nSpan
+	//
+	//+ Purpose:
+	//		Non-owning view of a contiguous array, used to hand out node arrays in bulk.
+	template <class T>
+	class nSpan {
+	public:
+		nSpan(T* pData, int count) : m_pData{ pData }, m_count{ count } {}
 
-	protected:
-		static int s_currentGlobalId;
+		T*   data()  const { return m_pData; }
+		int  size()  const { return m_count; }
+		bool empty() const { return m_count == 0; }
 
-		int   m_globalId;  // Globally identifies the node.
-		int   m_networkId; // Locally identifies the node. In a copied nNetwork (created via GetSnapshot())
-						   // matching nodes have matching ids.
+		T* begin() const { return m_pData; }
+		T* end()   const { return m_pData + m_count; }
+
+		T& operator[](int index) const { return m_pData[index]; }
+
+		nSpan subspan(int offset, int count) const { return nSpan{ m_pData + offset, count }; }
+
+	private:
+		T*  m_pData;
+		int m_count;
+	};
 
+	//++ nIncomingSynapses
+	//
+	//+ Purpose:
+	//		Transpose of a nSynapseStore: the incoming synapses of each node, ordered by source.
+	//
+	//+ Remarks:
+	//		The incoming synapses of node n occupy [RowOffsets[n], RowOffsets[n + 1]). Synapses
+	//		holds the index of each synapse in the nSynapseStore, so weights are always read from
+	//		the store.
+	struct nIncomingSynapses {
+		std::vector<int> RowOffsets;
+		std::vector<int> Sources;
+		std::vector<int> Synapses;
+
+		bool IsBuilt() const { return !RowOffsets.empty(); }
+	};
 
-		// The current VALUE of the node... The node will fire if m_currentValue goes above
+	//++ nBasicNodeStore
+	//
+	//+ Purpose:
+	//		Structure-of-arrays storage for the nodes of a network.
+	//
+	//+ Remarks:
+	//		Every node attribute is kept in its own contiguous array, indexed by network id.
+	//		Network ids are assigned layer by layer, so each layer occupies the contiguous range
+	//		[LayerOffsets[l], LayerOffsets[l + 1]) of every array. The per-tick decay pass is then a
+	//		linear sweep over CurrentValues, Decays and RestCounts. The node arrays are allocated
+	//		from pArena when there is one.
+	template <class V>
+	struct nBasicNodeStore {
+		nBasicNodeStore() : nBasicNodeStore(nullptr) {}
+		explicit nBasicNodeStore(nArena* pArena) : CurrentValues(pArena), Decays(pArena), RestCounts(pArena), MaxRestCounts(pArena) {}
+
+		// The current VALUE of each node... A node will fire if its value goes above
 		// NODE_TRIGGER_POINT;
-		vType m_currentValue{ 0 };
+		nArenaVector<V>    CurrentValues;
+
+		// Each value will decay by the matching amount on each tick.
+		nArenaVector<V>    Decays;
 
-		// m_currentValue will decay by this amount on each call to Tick.
-		vType m_decay{ 0.1 };
+		// When a node fires, its rest count is set to its max rest count. While the rest count is
+		// > 0 the node ignores incoming synapses, and each tick decrements the rest count.
+		nArenaVector<int>  RestCounts;
+		nArenaVector<int>  MaxRestCounts;
 
-		// Once a node fires, it must rest this many ticks before it can fire again.
-		int m_maxRestCount{ 2 };
+		// LayerOffsets[l] is the network id of the first node in layer l. The last entry is the
+		// total node count.
+		std::vector<int>   LayerOffsets{ 0 };
 
-		// When a node fires, m_restCount is set to m_maxRestCount. If m_restCount is > 0
-		// Tick decrements m_restCount rather and performing an actual tick. m_restCount
-		// must reach 0 before the node starts up again.
-		// ActivateFromSynapse() also does nothing if m_restCount > 0.
-		int m_restCount{ 0 };
+		int GetNodeCount()  const { return (int)CurrentValues.size(); }
+		int GetLayerCount() const { return (int)LayerOffsets.size() - 1; }
+		int GetLayerBegin(int layerIndex) const { return LayerOffsets[layerIndex]; }
+		int GetLayerEnd(int layerIndex)   const { return LayerOffsets[layerIndex + 1]; }
 
-		void Fire();
-		void ActivateFromSynapse(const nSynapse& synapse);
+		void Reserve(int nodeCount);
+		void AddNode(V decay, int maxRestCount);
+		void CloseLayer() { LayerOffsets.push_back(GetNodeCount()); }
 	};
 
-	//++ nSensingNode
+	//++ nBasicNode
 	//
 	//+ Purpose:
-	//		Node that is capable of a connection to an ISensor implementation.
-	class nSensingNode : public nNode
-	{
+	//		Lightweight handle to a node owned by a nNodeNetwork.
+	//
+	//+ Remarks:
+	//		A nNode does not hold any node state, it identifies a slot in the nNodeStore of the
+	//		network that produced it. Handles are cheap to copy and are only valid for as long as
+	//		that network.
+	template <class V>
+	class nBasicNode {
 	public:
-		nSensingNode(int networkId, const std::vector<int>& senseLocation) 
-			: nNode(networkId), m_senseLocation{ senseLocation } {};
-		nSensingNode(int networkId, vType decay, const std::vector<int>& senseLocation) 
-			: nNode{ networkId, decay }, m_senseLocation{ senseLocation } {};
-		nSensingNode(int networkId, vType decay, int maxRestCount, const std::vector<int>& senseLocation)
-			: nNode{ networkId, decay, maxRestCount }, m_senseLocation{ senseLocation } {};
-		virtual ~nSensingNode() {};
-
-		virtual void Sense(const ISensor& sensor);
+		nBasicNode(const nBasicNodeNetwork<V>* pNetwork, int networkId) : m_pNetwork{ pNetwork }, m_networkId{ networkId } {}
+
+		int GetNetworkId()    const { return m_networkId; }
+		int GetGlobalId()     const;
+		V   GetCurrentValue() const;
+		V   GetDecay()        const;
+		int GetRestCount()    const;
+		int GetMaxRestCount() const;
+
+		nBasicSynapseView<V> GetSynapses() const;
+
 	protected:
-		std::vector<int> m_senseLocation;
+		const nBasicNodeNetwork<V>* m_pNetwork;
+
+		// Locally identifies the node. In a copied nNetwork (created via GetSnapshot())
+		// matching nodes have matching ids.
+		int m_networkId;
+	};
+
+	//++ nBasicSensingNode
+	//
+	//+ Purpose:
+	//		Handle to a node in the sensing layer, these nodes are connected to an ISensor.
+	template <class V>
+	class nBasicSensingNode : public nBasicNode<V>
+	{
+	public:
+		nBasicSensingNode(const nBasicNodeNetwork<V>* pNetwork, int networkId) : nBasicNode<V>{ pNetwork, networkId } {}
+
+		// Linear offset of the node's sense location, -1 when the sensor has none, see
+		// ISensor::GetLinearOffset.
+		int GetSenseOffset() const;
 	};
 	
+	//++ nPropagationMode
+	//
+	//+ Purpose:
+	//		Selects how a spike travels through the network during a tick.
+	enum class nPropagationMode {
+		// Firing a node activates each of its targets immediately, which may fire the target
+		// in turn. The stack depth grows with the depth of the cascade.
+		Recursive,
+
+		// Firing a node pushes it onto a worklist that is drained in order. Because synapses
+		// only connect a layer to the layer above it, the worklist is a per-layer frontier and
+		// the results match Recursive exactly, with a bounded stack.
+		Queued,
+
+		// Double buffered: spikes fired during tick t are summed per target and applied at the
+		// start of tick t + 1, so nothing depends on node iteration order. Each target sums its
+		// inputs in ascending source order, which makes the results bit reproducible whatever
+		// the thread count. Delivery is split across the thread pool when there is one.
+		Synchronous
+	};
+
+	//++ nSenseGrid
+	//
+	//+ Purpose:
+	//		Bulk description of the sense locations of the sensing layer. Lets the network build
+	//		its sense offset table without calling nNodeNetworkConfig::pSensorLocationMapper once
+	//		per node.
+	//
+	//+ Remarks:
+	//		Dimensions == 1: sensing node n senses at { OriginX + n * StrideX }.
+	//		Dimensions == 2: sensing node n senses at
+	//			{ OriginX + (n % Columns) * StrideX, OriginY + (n / Columns) * StrideY }.
+	//		Strides larger than 1 tile the input, one sensing node per receptive field origin.
+	//		Dimensions == 0 disables the grid.
+	struct nSenseGrid {
+		int Dimensions{ 0 };
+		int Columns{ 1 };
+		int OriginX{ 0 };
+		int OriginY{ 0 };
+		int StrideX{ 1 };
+		int StrideY{ 1 };
+	};
+
+	//++ nConnectivity
+	//
+	//+ Purpose:
+	//		How the nodes of a layer connect to the nodes of the layer above it.
+	enum class nConnectivity {
+		// Every node connects to every node of the layer above.
+		Full,
+
+		// Every node connects to FanOut distinct, randomly chosen nodes of the layer above.
+		FixedFanOut,
+
+		// Every possible synapse exists with probability Probability.
+		Probability,
+
+		// Both layers are laid out as 2D grids and every node of the layer above receives the
+		// nodes in a (2 * FieldRadius + 1) square centred on its position in the layer below.
+		ReceptiveField
+	};
+
+	//++ nConnectivityProfile
+	//
+	//+ Remarks:
+	//		Grid widths for ReceptiveField: the sensing layer uses SenseGrid.Columns when the
+	//		sense grid is 2D, a layer built by a ReceptiveField profile uses FieldColumns, or the
+	//		aspect ratio of the layer below when FieldColumns is 0. Any other layer is one row.
+	struct nConnectivityProfile {
+		nConnectivity Type{ nConnectivity::Full };
+		int           FanOut{ 16 };
+		double        Probability{ 0.1 };
+		int           FieldRadius{ 1 };
+		int           FieldColumns{ 0 };
+	};
+
 	//++ nNodeNetworkConfig
 	//
 	//+ Purpose:
@@ -150,90 +388,411 @@ namespace nNetwork {
 		int MinRestCount;
 		int MaxRestCount;
 
+		// Maps the index of a sensing node to its sense location. Not used when SenseGrid is
+		// enabled.
 		std::vector<int>(*pSensorLocationMapper)(int);
+
+		nPropagationMode PropagationMode{ nPropagationMode::Queued };
+
+		nSenseGrid SenseGrid{};
+
+		// Number of threads used by Tick(), including the calling thread. 1 ticks on the calling
+		// thread only, 0 uses every hardware thread. The sense and decay phases are split into
+		// chunks of TickChunkSize nodes on a work stealing pool owned by the network.
+		int TickThreadCount{ 1 };
+		int TickChunkSize{ 4096 };
+
+		// Connectivity between layer l and layer l + 1 is LayerConnectivity[l] when there is
+		// such an entry, Connectivity otherwise.
+		nConnectivityProfile              Connectivity{};
+		std::vector<nConnectivityProfile> LayerConnectivity{};
+
+		// An nExecuter publishes the network state for GetSnapShot every SnapShotInterval ticks,
+		// and whenever it pauses.
+		int SnapShotInterval{ 16 };
+
+		// Seed of the network's nRandom. Networks built from the same layer counts, config and
+		// non zero seed are identical, whatever TickThreadCount is. 0 takes a new seed from
+		// nRandom::NextSeed.
+		uint64_t Seed{ 0 };
+
+		// Arena the node and synapse arrays are allocated from, see nArena. Null gives every
+		// network an arena of its own, sized from its layer counts. A caller supplied arena is
+		// shared by the networks built with this config and must outlive all of them. Snapshots
+		// always get an arena of their own, which they free when they are destroyed, so taking
+		// snapshots never grows the shared arena.
+		nArena* pArena{ nullptr };
+
+		// Count and time what every tick does, see nNodeNetwork::GetTickMetrics. Has no effect
+		// when N_TICK_METRICS is 0.
+		bool CollectTickMetrics{ false };
 	};
 
+	//++ nBasicNetworkState
+	//
+	//+ Purpose:
+	//		Everything that nNodeNetwork::Tick changes, see nNodeNetwork::GetState.
+	template <class V>
+	struct nBasicNetworkState {
+		std::vector<V>       CurrentValues;
+		std::vector<int>     RestCounts;
+		std::vector<uint8_t> Spikes;		// nPropagationMode::Synchronous only
+		int                  Iteration{ 0 };
+	};
+
+	//++ nBasicNetworkImage
+	//
+	//+ Purpose:
+	//		Everything that describes a network, as views of arrays owned by somebody else. Used
+	//		to save a network and to build one from saved arrays, see nNodeNetwork::GetImage.
+	//
+	//+ Remarks:
+	//		Node arrays are indexed by network id. The synapses are the CSR arrays of
+	//		nSynapseStore: RowOffsets has one entry per node plus one, Targets and Weights one per
+	//		synapse. Spikes is either empty or holds one flag per node.
+	template <class V>
+	struct nBasicNetworkImage {
+		nSpan<const int>     LayerCounts{ nullptr, 0 };
+		nSpan<const V>       CurrentValues{ nullptr, 0 };
+		nSpan<const V>       Decays{ nullptr, 0 };
+		nSpan<const int>     RestCounts{ nullptr, 0 };
+		nSpan<const int>     MaxRestCounts{ nullptr, 0 };
+		nSpan<const int>     RowOffsets{ nullptr, 0 };
+		nSpan<const int>     Targets{ nullptr, 0 };
+		nSpan<const V>       Weights{ nullptr, 0 };
+		nSpan<const uint8_t> Spikes{ nullptr, 0 };
+	};
 
 
+	//++ nBasicNodeNetwork
+	//
 	//+ Purpose:
-	//		Container for a neural network.
-	class nNodeNetwork
+	//		Container for a neural network whose node values, decays and weights are of type V.
+	//
+	//+ Remarks:
+	//		V is double, float or nFixed16, the three types the engine is instantiated for, so
+	//		networks of every type can be used side by side. Sensors and the config stay in vType,
+	//		sensed values are converted to V as they are added to the sensing nodes.
+	//		nNodeNetwork is the double network, which is the one nExecuter, nPopulation and the
+	//		network files work with.
+	template <class V>
+	class nBasicNodeNetwork
 	{
+		friend class nBasicNode<V>;
+		friend class nBasicSensingNode<V>;
 	public:
-		nNodeNetwork(const std::vector<int>& layerCounts, const ISensor& sensor);
-		nNodeNetwork(const std::vector<int>& layerCounts, const ISensor& sensor, const nNodeNetworkConfig& config);
-		~nNodeNetwork();
+		nBasicNodeNetwork(const std::vector<int>& layerCounts, const ISensor& sensor);
+		nBasicNodeNetwork(const std::vector<int>& layerCounts, const ISensor& sensor, const nNodeNetworkConfig& config);
+
+		// Build a network from an image, copying its arrays. The image is validated first.
+		// Sense locations come from config, as they do for a new network.
+		nBasicNodeNetwork(const nBasicNetworkImage<V>& image, const ISensor& sensor, const nNodeNetworkConfig& config);
+		~nBasicNodeNetwork();
 
 		void Tick();
+
+		// Tick as Tick() does, with the sensor of the network bound statically as a TSensor,
+		// which must be its concrete type. When TSensor is final (BoundIntegralSensor for
+		// instance) SenseBatch is called without a virtual call and inlines into the sense loop.
+		template <class TSensor>
+		void Tick();
 		
-		std::unique_ptr<nNodeNetwork> GetSnapShot() const;
+		// Snapshots copy the layout, node parameters and weights of this network in one pass,
+		// nothing is regenerated. The result gets its own block of global ids and its own arena,
+		// its config has a null pArena.
+		std::unique_ptr<nBasicNodeNetwork<V>> GetSnapShot() const;
+		std::unique_ptr<nBasicNodeNetwork<V>> GetSnapShot(const nBasicNetworkState<V>& state) const;
+
+		// Copy this network into destination, which must have the same layer counts. The copy
+		// reuses the storage of destination, so repeated snapshots into it allocate nothing.
+		void GetSnapShot(nBasicNodeNetwork<V>& destination) const;
+
+		// Copy the tick state into state, reusing its storage.
+		void GetState(nBasicNetworkState<V>& state) const;
+
+		// Replace the tick state, state must come from a network with the same layer counts.
+		void SetState(const nBasicNetworkState<V>& state);
+
+		// View this network as an image. The views stay valid until the network is ticked or
+		// destroyed; LayerCounts points into layerCounts, which the caller keeps alive.
+		nBasicNetworkImage<V> GetImage(std::vector<int>& layerCounts) const;
+
+		// As above, with the tick state taken from state instead of from this network. Only the
+		// arrays that do not change while the network ticks are read, so this is safe while
+		// another thread ticks it.
+		nBasicNetworkImage<V> GetImage(std::vector<int>& layerCounts, const nBasicNetworkState<V>& state) const;
 
 		std::vector<int> GetLayerCounts() const;
+		int              GetSynapseCount() const { return m_synapses.GetSynapseCount(); }
 
 		const ISensor& GetSensor() const;
 
-		const nNode& GetNodeByGlobalId(int globalId)   const;
-		const nNode& GetNodeByNetworkId(int networkId) const;
+		const nNodeNetworkConfig& GetConfig() const { return m_config; }
+
+		nPropagationMode GetPropagationMode() const { return m_config.PropagationMode; }
+		void             SetPropagationMode(nPropagationMode mode) { m_config.PropagationMode = mode; }
+
+		nBasicNode<V> GetNodeByGlobalId(int globalId)   const;
+		nBasicNode<V> GetNodeByNetworkId(int networkId) const;
+
+		// Global ids of this network are the contiguous block starting at GetGlobalIdBase, in
+		// network id order. FindNetworkId returns -1 for a global id of another network.
+		int GetGlobalIdBase() const { return m_globalIdBase; }
+		int FindNetworkId(int globalId) const;
+
+		// The seed the network was generated from, see nNodeNetworkConfig::Seed.
+		uint64_t GetSeed() const { return m_random.GetSeed(); }
+
+		// The arena of the node and synapse arrays, see nNodeNetworkConfig::pArena.
+		const nArena& GetArena() const { return *m_pArena; }
+
+#if N_TICK_METRICS
 
-		void ForEach(std::function<void(const nNode&)> fn) const;
+		// The metrics of the last tick and their total over every tick counted, all 0 until a
+		// tick with nNodeNetworkConfig::CollectTickMetrics set. Lock free, any thread may call
+		// this while another one ticks the network.
+		void GetTickMetrics(nTickMetrics& lastTick, nTickMetrics& total) const { m_metricsBoard.Read(lastTick, total); }
+
+		void SetCollectTickMetrics(bool collect) { m_config.CollectTickMetrics = collect; }
+
+#endif
+
+		// Bulk access to the node arrays, indexed by network id. Layer layer covers the network
+		// ids [GetLayerBegin(layer), GetLayerEnd(layer)), use subspan to view a single layer.
+		int GetNodeCount() const { return m_nodes.GetNodeCount(); }
+		int GetLayerBegin(int layer) const;
+		int GetLayerEnd(int layer) const;
+
+		nSpan<const V>   GetCurrentValues() const { return { m_nodes.CurrentValues.data(), GetNodeCount() }; }
+		nSpan<const V>   GetDecays()        const { return { m_nodes.Decays.data(), GetNodeCount() }; }
+		nSpan<const int> GetRestCounts()    const { return { m_nodes.RestCounts.data(), GetNodeCount() }; }
+		nSpan<const int> GetMaxRestCounts() const { return { m_nodes.MaxRestCounts.data(), GetNodeCount() }; }
+
+		// Linear sense offset of each sensing node, see nSensingNode::GetSenseOffset.
+		nSpan<const int> GetSenseOffsets()  const { return { m_senseOffsets.data(), (int)m_senseOffsets.size() }; }
+
+		void ForEach(std::function<void(const nBasicNode<V>&)> fn) const;
 
 #ifdef __DEBUG__
 
-		nNode* GetResultNode();
-		std::vector<nSensingNode*>* GetSensingNodes();
-		std::vector<nNode*>* GetLayer(int layerIndex);
-		vType GetCurrentValue() const { return m_pResultNode->GetCurrentValue(); }
+		nBasicNode<V> GetResultNode() const;
+		std::vector<nBasicSensingNode<V>> GetSensingNodes() const;
+		std::vector<nBasicNode<V>> GetLayer(int layerIndex) const;
+		V GetCurrentValue() const { return m_nodes.CurrentValues.back(); }
 
 #endif
 
 	private:
+		// Used by GetSnapShot, copies source and then sets its tick state to state.
+		nBasicNodeNetwork(const nBasicNodeNetwork<V>& source, const nBasicNetworkState<V>& state);
+
 		nNodeNetworkConfig m_config;
 		const ISensor&     m_sensor;
 		int                m_nextNetworkId;
 
+		// Global ids are handed out to networks in contiguous blocks, shared by networks of every
+		// value type, see ReserveGlobalIds. A node's global id is m_globalIdBase + its network id.
+		int m_globalIdBase;
+
+		// Generates the node parameters and synapses, every value keyed by the node or synapse
+		// it belongs to.
+		nRandom m_random;
+
 		// m_tickCount is used to determine when to call sense on the sensing nodes. Its just
 		// used to track the ratio between SenseTick and NodeTick
 		int m_tickCount;
 
-		// Call Sense() on all sensing nodes.
-		void SenseTick();
+		// Senses the sensing nodes [begin, end) of network, see SenseRange.
+		using nSenseRangeFn = void(*)(nBasicNodeNetwork<V>& network, int begin, int end);
+
+		// Tick, sensing through senseRange.
+		void TickWith(nSenseRangeFn senseRange);
+
+		// Sense and propagate on all sensing nodes.
+		void SenseTick(nSenseRangeFn senseRange);
 
-		// Call Tick() on all nodes.
+		// Decay all nodes.
 		void NodeTick();
 
-		// _layers is the owner of the network memory.
-		std::vector<std::vector<nNode*>*> m_layers;
+		// The arena of m_nodes and m_synapses, m_pOwnedArena when the config does not supply
+		// one. Declared before them so that it is built first and destroyed last.
+		std::unique_ptr<nArena> m_pOwnedArena;
+		nArena*                 m_pArena;
+
+		// m_nodes is the owner of the node state. The sensing layer is layer 0 and the result
+		// node is the last node in the store.
+		nBasicNodeStore<V> m_nodes;
+
+		// Outgoing synapses of every node.
+		nBasicSynapseStore<V> m_synapses;
+
+		// Linear sense offset of each sensing node, indexed by network id. Built once from the
+		// config by BuildSenseOffsets, sensing is then a gather over this table.
+		std::vector<int> m_senseOffsets;
+
+		// Sense location of each sensing node whose offset is -1, indexed by network id. Empty
+		// when the sensor has a linear offset for every sensing node.
+		std::vector<std::vector<int>> m_senseLocations;
+
+		// Values returned by ISensor::SenseBatch for the sensing layer.
+		std::vector<vType> m_sensedValues;
+
+		// Runs the parallel parts of building and of Tick() when m_config.TickThreadCount != 1,
+		// null otherwise.
+		std::unique_ptr<nThreadPool> m_pThreadPool;
+
+		// Nodes that have fired but whose spikes have not been delivered yet
+		// (nPropagationMode::Queued only).
+		std::vector<int> m_spikeQueue;
+
+		// nPropagationMode::Synchronous only, built on the first synchronous tick.
+		// m_spikes flags the nodes that fired during the previous tick, m_nextSpikes the nodes
+		// firing during this one. m_input accumulates the weighted input of every node.
+		nIncomingSynapses    m_incoming;
+		std::vector<uint8_t> m_spikes;
+		std::vector<uint8_t> m_nextSpikes;
+		std::vector<V>       m_input;
+
+#if N_TICK_METRICS
+		// Counted by the tick in progress, added to m_totalMetrics and published to
+		// m_metricsBoard when it ends. Only used while m_config.CollectTickMetrics is set.
+		nTickMetrics      m_tickMetrics;
+		nTickMetrics      m_totalMetrics;
+		nTickMetricsBoard m_metricsBoard;
+
+		void CountSynchronousActivations();
+		void PublishTickMetrics();
+#endif
 
-		// _topLayer contains pointers to nodes owned by m_layers.
-		std::vector<nSensingNode*> m_sensingLayer;
+		/*-----------------------------------------------------------------------------------------
+			Node behaviour, see nNode.cpp.
+		-----------------------------------------------------------------------------------------*/
+		void Fire(int networkId);
+		void ActivateFromSynapse(int target, V weight);
+		void Propagate(int networkId);
+		void DecayRange(int begin, int end);
+
+		// Sense the sensing nodes [begin, end) of network through its sensor as a TSensor.
+		template <class TSensor>
+		static void SenseRange(nBasicNodeNetwork<V>& network, int begin, int end);
 
-		// m_pResultNode is also owned by m_layers
-		nNode*	m_pResultNode;
+		void BuildIncomingSynapses();
+		void SynchronousTick();
+		void GatherInputRange(int begin, int end);
+		void ApplyInputRange(int begin, int end);
 
 		/*-----------------------------------------------------------------------------------------
 			Network building methods.
 		-----------------------------------------------------------------------------------------*/
 		void BuildFirstLayer(int count, const ISensor& sensor);
 		void BuildNextLayer(int count);
+		void BuildSenseOffsets(int count, const ISensor& sensor);
 		void BuildNetwork(const std::vector<int>& layerCounts, const ISensor& sensor);
-		void BuildSynapses() const;
-		void BuildLayerSynapses(const std::vector<nNode*>* const bottomLayer, const std::vector<nNode*>* const topLayer) const;
-		void CopySensingLayer();
-		void CopyResultNode();
-
-		/*-----------------------------------------------------------------------------------------
-			Methods used for copying a network.
-		-----------------------------------------------------------------------------------------*/
-		nNode& GetMutableNodeByGlobalId(int globalId) const;
-		nNode& GetMutableNodeByNetworkId(int networkId) const;
-		
+		void BuildSynapses(int synapseCount);
+		int  EstimateSynapseCount(const std::vector<int>& layerCounts) const;
+		static size_t GetArenaSize(int nodeCount, int synapseCount);
+		void BuildLayerSynapses(int bottomLayer, int topLayer);
+		void FillFixedFanOutRow(int bottomNode, int topBegin, int topCount, int fanOut);
+		int  WalkProbabilityRow(int bottomNode, int topBegin, int topCount, double probability, int* pTargets) const;
+		void BuildReceptiveFieldSynapses(int bottomLayer, int topLayer, int radius);
+		void ParallelFor(int count, const std::function<void(int, int)>& fn);
+		const nConnectivityProfile& GetConnectivity(int bottomLayer) const;
+		int  GetLayerColumns(int layer) const;
+		void DeliverSpike(int networkId);
+		void CheckNetworkId(int networkId) const;
+		void CheckLayer(int layer) const;
+		void CheckSameLayout(const nBasicNodeNetwork<V>& other) const;
+		void CheckImage(const nBasicNetworkImage<V>& image) const;
+		nBasicNetworkImage<V> GetLayoutImage(std::vector<int>& layerCounts) const;
 	};
 
+	template <class V>
+	template <class TSensor>
+	void nBasicNodeNetwork<V>::Tick()
+	{
+		assert(dynamic_cast<const TSensor*>(&m_sensor));
+		TickWith(&nBasicNodeNetwork<V>::SenseRange<TSensor>);
+	}
+
+	template <class V>
+	template <class TSensor>
+	void nBasicNodeNetwork<V>::SenseRange(nBasicNodeNetwork<V>& network, int begin, int end)
+		// Sense the sensing nodes [begin, end) and add the sensed values, converted to V, to them.
+		// Defined here so that a concrete sensor type can be inlined, see Tick<TSensor>.
+	{
+		const TSensor& sensor   = static_cast<const TSensor&>(network.m_sensor);
+		const int*     pOffsets = network.m_senseOffsets.data();
+		vType*         pSensed  = network.m_sensedValues.data();
+		V*             pValues  = network.m_nodes.CurrentValues.data();
+
+		if (network.m_senseLocations.empty())
+			sensor.SenseBatch(pOffsets + begin, end - begin, pSensed + begin);
+		else {
+			// The sensor has no linear offset for some of the nodes, those are sensed one at a time.
+			for (int x = begin; x < end; ++x) {
+				if (pOffsets[x] < 0)
+					pSensed[x] = sensor.Sense(network.m_senseLocations[x]);
+				else
+					sensor.SenseBatch(pOffsets + x, 1, pSensed + x);
+			}
+		}
+
+		for (int x = begin; x < end; ++x)
+			pValues[x] += (V)pSensed[x];
+	}
+
+	// Reserve count consecutive global ids and return the first one.
+	int ReserveGlobalIds(int count);
+
+	using nSynapse      = nBasicSynapse<vType>;
+	using nSynapseStore = nBasicSynapseStore<vType>;
+	using nSynapseView  = nBasicSynapseView<vType>;
+	using nNodeStore    = nBasicNodeStore<vType>;
+	using nNode         = nBasicNode<vType>;
+	using nSensingNode  = nBasicSensingNode<vType>;
+	using nNetworkState = nBasicNetworkState<vType>;
+	using nNetworkImage = nBasicNetworkImage<vType>;
+	using nNodeNetwork  = nBasicNodeNetwork<vType>;
+
+	using nNodeNetworkF32 = nBasicNodeNetwork<float>;
+	using nNodeNetworkQ16 = nBasicNodeNetwork<nFixed16>;
+
+	//++ nExecuterContext
+	//
+	//+ Purpose:
+	//		State shared between an nExecuter and the thread that ticks its network.
+	//
+	//+ Remarks:
+	//		The tokens are written by the owning thread and read by the executer thread once per
+	//		tick, with release/acquire ordering. A paused executer blocks on Wake instead of
+	//		spinning; tokens that wake it are written while ParkLock is held so no wake is lost.
+	//
+	//		The executer thread publishes the network state into SnapShots and never waits for a
+	//		reader. Lock only serialises readers, which take turns on the reading end of SnapShots.
 	struct nExecuterContext {
-		int  ExitToken{ 0 };
-		int  PauseToken{ 1 };
-		int  CurrentIteration{ 0 };
-		mutable std::mutex Lock;
+		std::atomic<int>  ExitToken{ 0 };
+		std::atomic<int>  PauseToken{ 1 };
+		std::atomic<int>  CurrentIteration{ 0 };
+
+		mutable nTripleBuffer<nNetworkState> SnapShots;
+		int                          SnapShotInterval{ 16 };
+
+		// Iteration of the last publication, only used by the thread that ticks.
+		int                          Published{ 0 };
+
+		mutable std::mutex      Lock;
+		std::mutex              ParkLock;
+		std::condition_variable Wake;
+
+		// Ticking side: Tick ticks the network once, counts the iteration and publishes when
+		// SnapShotInterval ticks have passed. PublishPending publishes any unpublished ticks.
+		void Tick(nNodeNetwork& network);
+		void Publish(const nNodeNetwork& network);
+		void PublishPending(const nNodeNetwork& network);
+
+		// Reading side, see nExecuter.
+		void GetState(nNetworkState& state) const;
+		std::unique_ptr<nNodeNetwork> GetSnapShot(const nNodeNetwork& network) const;
 	};
 
 	class nExecuter
@@ -244,6 +803,10 @@ namespace nNetwork {
 		nExecuter(const std::vector<int>& layerCounts, const ISensor& sensor);
 		nExecuter(const std::vector<int>& layerCounts, const ISensor& sensor, nNodeNetworkConfig config);
 
+		// Execute an existing network, for instance one loaded from a checkpoint. Iteration
+		// counting continues from currentIteration.
+		nExecuter(std::unique_ptr<nNodeNetwork> pNetwork, int currentIteration);
+
 		void Start();
 		void Pause();
 		void Exit();
@@ -252,11 +815,22 @@ namespace nNetwork {
 
 		std::unique_ptr<nNodeNetwork> GetSnapShot() const;
 
+		// Copy the last published state into state, reusing its storage.
+		void GetState(nNetworkState& state) const;
+
+		// Image of the network with its last published state, which is copied into state.
+		// The layout and weights are read from the running network, they never change; its
+		// current values, rest counts and spikes are never read.
+		nNetworkImage GetImage(nNetworkState& state, std::vector<int>& layerCounts) const;
+
 	private:
 		std::unique_ptr<nNodeNetwork> m_pNetwork;
 		std::unique_ptr<std::thread>  m_pThread;
 		nExecuterContext              m_executerContext;
 
+		void Launch();
+		void SetToken(std::atomic<int>& token, int value);
+
 		static void ThreadExecuter(nNodeNetwork *pNetwork, nExecuterContext *pContext);
 	};
 
@@ -270,10 +844,11 @@ namespace nNetwork {
 //+	The Network Tick:
 //		In a nutshell, the network does its thing by repeatedly calling nNodeNetwork::Tick. nNodeNetwork::Tick does two
 //		things:
-//			a) nNodeNetwork::Tick calls nSensingNode::Sense on every sensing node in the network.
-//			b) nNodeNetwork::Tick calls nNode::Tick on every node in the network.
+//			a) nNodeNetwork::Tick senses a value for every sensing node in the network.
+//			b) nNodeNetwork::Tick decays every node in the network.
 //+ Node Sensing:
 //+ Node Ticking:
+//		nNodeNetwork::NodeTick decays every node with one linear pass over the nNodeStore arrays.
 //
 //++ nNode
 //++ nNode
\ No newline at end of file
@@ -1,60 +1,364 @@
 #include "stdafx.h"
 #include "nNetwork.h"
+#include "nTickKernels.h"
+#include "nThreadPool.h"
+
+#include <algorithm>
 
 using namespace std;
 using namespace nNetwork;
 
-int nNode::s_currentGlobalId{ 0 };
+// Count a tick metric of the network, see nTickMetrics.
+#if N_TICK_METRICS
+#define N_COUNT_TICK_METRIC(field) do { if (m_config.CollectTickMetrics) ++m_tickMetrics.field; } while (0)
+#else
+#define N_COUNT_TICK_METRIC(field) do {} while (0)
+#endif
+
+/*-------------------------------------------------------------------------------------------------
+	nBasicNodeStore
+-------------------------------------------------------------------------------------------------*/
+
+template <class V>
+void nBasicNodeStore<V>::Reserve(int nodeCount)
+{
+	CurrentValues.reserve(nodeCount);
+	Decays.reserve(nodeCount);
+	RestCounts.reserve(nodeCount);
+	MaxRestCounts.reserve(nodeCount);
+}
+
+template <class V>
+void nBasicNodeStore<V>::AddNode(V decay, int maxRestCount)
+{
+	CurrentValues.push_back(0);
+	Decays.push_back(decay);
+	RestCounts.push_back(0);
+	MaxRestCounts.push_back(maxRestCount);
+}
+
+/*-------------------------------------------------------------------------------------------------
+	nBasicNode
+-------------------------------------------------------------------------------------------------*/
+
+template <class V>
+int nBasicNode<V>::GetGlobalId() const
+{
+	return m_pNetwork->m_globalIdBase + m_networkId;
+}
+
+template <class V>
+V nBasicNode<V>::GetCurrentValue() const
+{
+	return m_pNetwork->m_nodes.CurrentValues[m_networkId];
+}
+
+template <class V>
+V nBasicNode<V>::GetDecay() const
+{
+	return m_pNetwork->m_nodes.Decays[m_networkId];
+}
+
+template <class V>
+int nBasicNode<V>::GetRestCount() const
+{
+	return m_pNetwork->m_nodes.RestCounts[m_networkId];
+}
+
+template <class V>
+int nBasicNode<V>::GetMaxRestCount() const
+{
+	return m_pNetwork->m_nodes.MaxRestCounts[m_networkId];
+}
 
-nNode::nNode(int networkId) : m_networkId{ networkId }
+template <class V>
+nBasicSynapseView<V> nBasicNode<V>::GetSynapses() const
 {
-	m_globalId = s_currentGlobalId++;
+	const nBasicSynapseStore<V>& synapses = m_pNetwork->m_synapses;
+	int begin = synapses.GetRowBegin(m_networkId);
+
+	return nBasicSynapseView<V>{
+		synapses.Targets.data() + begin,
+		synapses.Weights.data() + begin,
+		synapses.GetRowEnd(m_networkId) - begin
+	};
 }
 
-nNode::~nNode() {}
+/*-------------------------------------------------------------------------------------------------
+	Node behaviour. The node state lives in nBasicNodeNetwork::m_nodes, so firing and activation
+	are implemented by the network.
+-------------------------------------------------------------------------------------------------*/
+
+template <class V>
+void nBasicNodeNetwork<V>::DeliverSpike(int networkId)
+	// Activate every synapse leaving networkId. The synapses of a node are contiguous in
+	// m_synapses.
+{
+	const int* pTargets = m_synapses.Targets.data();
+	const V*   pWeights = m_synapses.Weights.data();
+	int        end      = m_synapses.GetRowEnd(networkId);
+
+	for (int x = m_synapses.GetRowBegin(networkId); x < end; ++x)
+		ActivateFromSynapse(pTargets[x], pWeights[x]);
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::Propagate(int networkId)
+	// Deliver the spike of networkId along with every spike that it causes. In Queued mode the
+	// nodes fired by a delivery are appended to m_spikeQueue, layer by layer, and delivered
+	// here in order rather than from inside Fire().
+{
+	DeliverSpike(networkId);
+
+	for (size_t head = 0; head < m_spikeQueue.size(); ++head)
+		DeliverSpike(m_spikeQueue[head]);
+
+	m_spikeQueue.clear();
+}
 
-void nNode::Fire()
+template <class V>
+void nBasicNodeNetwork<V>::Fire(int networkId)
 {
-	if (!m_restCount)
+	if (!m_nodes.RestCounts[networkId])
 	{
-		for (auto synapse : Synapses)
-			synapse.pNode->ActivateFromSynapse(synapse);
+		N_COUNT_TICK_METRIC(Fired);
+
+		if (m_config.PropagationMode == nPropagationMode::Queued)
+			m_spikeQueue.push_back(networkId);
+		else
+			DeliverSpike(networkId);
 
 		// After firing the node rests.
-		m_restCount = m_maxRestCount;
+		m_nodes.RestCounts[networkId] = m_nodes.MaxRestCounts[networkId];
 
 		// And the current value decays to 0
-		m_currentValue = 0;
+		m_nodes.CurrentValues[networkId] = 0;
 	}
 }
 
-void nNode::ActivateFromSynapse(const nSynapse& synapse)
-	// Called by another node when the other node is firing....
+template <class V>
+void nBasicNodeNetwork<V>::ActivateFromSynapse(int target, V weight)
+	// Called when the node on the other end of the synapse is firing....
 {
+	N_COUNT_TICK_METRIC(Activations);
 
-	if (!m_restCount)
+	if (m_nodes.RestCounts[target])
 	{
-		m_currentValue += synapse.weight;
+		N_COUNT_TICK_METRIC(AbsorbedActivations);
+		return;
+	}
+
+	V& currentValue = m_nodes.CurrentValues[target];
+
+	currentValue += weight;
+
+	// Keep the current value clipped to 1.0
+	if (currentValue > 1.0)
+		currentValue = 1.0;
+
+	if (currentValue > NODE_TRIGGER_POINT)
+		Fire(target);
+}
+
+/*-------------------------------------------------------------------------------------------------
+	nPropagationMode::Synchronous
+-------------------------------------------------------------------------------------------------*/
+
+template <class V>
+void nBasicNodeNetwork<V>::BuildIncomingSynapses()
+	// Transpose m_synapses. Sources are visited in ascending order, so every incoming row is
+	// sorted by source.
+{
+	int nodeCount = m_nodes.GetNodeCount();
 
-		// Keep m_currentValue clipped to 1.0
-		if (m_currentValue > 1.0)
-			m_currentValue = 1.0;
+	m_incoming.RowOffsets.assign(nodeCount + 1, 0);
+	for (auto target : m_synapses.Targets)
+		++m_incoming.RowOffsets[target + 1];
+	for (int x = 0; x < nodeCount; ++x)
+		m_incoming.RowOffsets[x + 1] += m_incoming.RowOffsets[x];
 
-		if (m_currentValue > NODE_TRIGGER_POINT)
-			Fire();
+	m_incoming.Sources.resize(m_synapses.GetSynapseCount());
+	m_incoming.Synapses.resize(m_synapses.GetSynapseCount());
+
+	vector<int> next(m_incoming.RowOffsets.begin(), m_incoming.RowOffsets.end() - 1);
+	for (int source = 0; source < nodeCount; ++source) {
+		for (int synapse = m_synapses.GetRowBegin(source); synapse < m_synapses.GetRowEnd(source); ++synapse) {
+			int slot = next[m_synapses.Targets[synapse]]++;
+			m_incoming.Sources[slot]  = source;
+			m_incoming.Synapses[slot] = synapse;
+		}
 	}
+
+	m_spikes.assign(nodeCount, 0);
+	m_nextSpikes.assign(nodeCount, 0);
+	m_input.assign(nodeCount, 0);
 }
 
-void nNode::Tick()
-	// The node decays on each tick.
-	// If the node is resting (m_restCount > 0) decrement m_restCount.
+template <class V>
+void nBasicNodeNetwork<V>::GatherInputRange(int begin, int end)
+	// Per target reduction: sum the weights of the incoming synapses whose source fired during
+	// the previous tick, in ascending source order.
 {
+	const int*     pRows     = m_incoming.RowOffsets.data();
+	const int*     pSources  = m_incoming.Sources.data();
+	const int*     pSynapses = m_incoming.Synapses.data();
+	const V*       pWeights  = m_synapses.Weights.data();
+	const uint8_t* pSpikes   = m_spikes.data();
+
+	for (int target = begin; target < end; ++target) {
+		V input = 0;
+		for (int x = pRows[target]; x < pRows[target + 1]; ++x) {
+			if (pSpikes[pSources[x]])
+				input += pWeights[pSynapses[x]];
+		}
+		m_input[target] = input;
+	}
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::ApplyInputRange(int begin, int end)
+	// Add the accumulated input to every node that is not resting. A node that crosses
+	// NODE_TRIGGER_POINT fires, its spike is delivered during the next tick.
+{
+	for (int x = begin; x < end; ++x)
+	{
+		m_nextSpikes[x] = 0;
+
+		if (m_nodes.RestCounts[x] || m_input[x] == 0)
+			continue;
+
+		V& currentValue = m_nodes.CurrentValues[x];
+
+		currentValue += m_input[x];
 
-	m_currentValue -= m_decay;
-	if (m_currentValue < 0)
-		m_currentValue = 0;
+		// Keep the current value clipped to 1.0
+		if (currentValue > 1.0)
+			currentValue = 1.0;
 
-	if (m_restCount)
-		--m_restCount;
+		if (currentValue > NODE_TRIGGER_POINT) {
+			m_nodes.RestCounts[x] = m_nodes.MaxRestCounts[x];
+			currentValue = 0;
+			m_nextSpikes[x] = 1;
+		}
+	}
 }
- 
\ No newline at end of file
+
+template <class V>
+void nBasicNodeNetwork<V>::SynchronousTick()
+	// Deliver the spikes fired during the previous tick.
+	// Without a thread pool the spikes are pushed from each source, in ascending source order,
+	// into m_input. With a pool each target pulls its own input. Either way every target adds up
+	// its inputs in the same order, so both produce the same bits.
+{
+	if (!m_incoming.IsBuilt())
+		BuildIncomingSynapses();
+
+	int nodeCount = m_nodes.GetNodeCount();
+
+	if (m_pThreadPool) {
+		m_pThreadPool->ParallelFor(nodeCount, m_config.TickChunkSize, [this](int begin, int end) {
+			GatherInputRange(begin, end);
+			ApplyInputRange(begin, end);
+		});
+		return;
+	}
+
+	fill(m_input.begin(), m_input.end(), (V)0);
+
+	const int* pTargets = m_synapses.Targets.data();
+	const V*   pWeights = m_synapses.Weights.data();
+
+	for (int source = 0; source < nodeCount; ++source) {
+		if (!m_spikes[source])
+			continue;
+		for (int x = m_synapses.GetRowBegin(source); x < m_synapses.GetRowEnd(source); ++x)
+			m_input[pTargets[x]] += pWeights[x];
+	}
+
+	ApplyInputRange(0, nodeCount);
+}
+
+#if N_TICK_METRICS
+
+template <class V>
+void nBasicNodeNetwork<V>::CountSynchronousActivations()
+	// Count the activations of the spikes delivered by this tick, before they are applied, see
+	// ApplyInputRange. m_spikes is empty until the first synchronous tick.
+{
+	int nodeCount = (int)m_spikes.size();
+
+	for (int source = 0; source < nodeCount; ++source) {
+		if (!m_spikes[source])
+			continue;
+		for (int x = m_synapses.GetRowBegin(source); x < m_synapses.GetRowEnd(source); ++x) {
+			++m_tickMetrics.Activations;
+			if (m_nodes.RestCounts[m_synapses.Targets[x]])
+				++m_tickMetrics.AbsorbedActivations;
+		}
+	}
+}
+
+#endif
+
+template <class V>
+void nBasicNodeNetwork<V>::DecayRange(int begin, int end)
+{
+	TickNodes(
+		m_nodes.CurrentValues.data() + begin,
+		m_nodes.Decays.data() + begin,
+		m_nodes.RestCounts.data() + begin,
+		end - begin
+	);
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::NodeTick()
+	// Every node decays on each tick.
+	// If a node is resting (rest count > 0) decrement its rest count.
+	// The sweep is done by the widest tick kernel that the CPU supports for double networks, by
+	// the scalar loop for other value types, see nTickKernels.h, and is split across the thread
+	// pool when there is one.
+{
+	int count = m_nodes.GetNodeCount();
+
+	if (m_pThreadPool)
+		m_pThreadPool->ParallelFor(count, m_config.TickChunkSize, [this](int begin, int end) { DecayRange(begin, end); });
+	else
+		DecayRange(0, count);
+}
+
+/*-------------------------------------------------------------------------------------------------
+	Explicit instantiations. nNodeNetwork.cpp instantiates the nBasicNodeNetwork members it
+	defines, the members defined here are instantiated one by one.
+-------------------------------------------------------------------------------------------------*/
+
+template struct nNetwork::nBasicNodeStore<double>;
+template struct nNetwork::nBasicNodeStore<float>;
+template struct nNetwork::nBasicNodeStore<nFixed16>;
+
+template class nNetwork::nBasicNode<double>;
+template class nNetwork::nBasicNode<float>;
+template class nNetwork::nBasicNode<nFixed16>;
+
+#if N_TICK_METRICS
+#define N_INSTANTIATE_SYNCHRONOUS_METRICS(V) template void nNetwork::nBasicNodeNetwork<V>::CountSynchronousActivations();
+#else
+#define N_INSTANTIATE_SYNCHRONOUS_METRICS(V)
+#endif
+
+#define N_INSTANTIATE_NODE_BEHAVIOUR(V) \
+	template void nNetwork::nBasicNodeNetwork<V>::DeliverSpike(int); \
+	template void nNetwork::nBasicNodeNetwork<V>::Propagate(int); \
+	template void nNetwork::nBasicNodeNetwork<V>::Fire(int); \
+	template void nNetwork::nBasicNodeNetwork<V>::ActivateFromSynapse(int, V); \
+	template void nNetwork::nBasicNodeNetwork<V>::BuildIncomingSynapses(); \
+	template void nNetwork::nBasicNodeNetwork<V>::GatherInputRange(int, int); \
+	template void nNetwork::nBasicNodeNetwork<V>::ApplyInputRange(int, int); \
+	template void nNetwork::nBasicNodeNetwork<V>::SynchronousTick(); \
+	N_INSTANTIATE_SYNCHRONOUS_METRICS(V) \
+	template void nNetwork::nBasicNodeNetwork<V>::DecayRange(int, int); \
+	template void nNetwork::nBasicNodeNetwork<V>::NodeTick();
+
+N_INSTANTIATE_NODE_BEHAVIOUR(double)
+N_INSTANTIATE_NODE_BEHAVIOUR(float)
+N_INSTANTIATE_NODE_BEHAVIOUR(nFixed16)
@@ -1,5 +1,12 @@
 #include "stdafx.h"
 #include "nNetwork.h"
+#include "nThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
 
 using namespace nNetwork;
 using namespace std;
@@ -17,272 +24,904 @@ nNodeNetworkConfig DefaultConfig {
 	[](int nodeLocation) { return vector<int>{nodeLocation}; }
 };
 
-vType GenerateInitialWeight(const nNodeNetworkConfig &config) {
-	vType r = (vType)rand() / (vType)INT_MAX;
-	vType min = config.MinInitialSynapseWeight;
-	vType delta = config.MaxInitialSynapseWeight - config.MinInitialSynapseWeight;
+// The initial weight of the synapse from source to target.
+double GenerateInitialWeight(const nNodeNetworkConfig &config, const nRandom& random, int source, int target) {
+	double r = random.GetUniform(nRandomStream::Weight, nRandom::Pair(source, target));
+	double min = config.MinInitialSynapseWeight;
+	double delta = config.MaxInitialSynapseWeight - config.MinInitialSynapseWeight;
 
 	return min + (delta * r);
 }
 
-vType GenerateInitialDecay(const nNodeNetworkConfig &config) {
-	vType r = (vType)rand() / (vType)INT_MAX;
-	vType min = config.MinInitialDecay;
-	vType delta = config.MaxInitialDecay - config.MinInitialDecay;
+double GenerateInitialDecay(const nNodeNetworkConfig &config, const nRandom& random, int networkId) {
+	double r = random.GetUniform(nRandomStream::Decay, networkId);
+	double min = config.MinInitialDecay;
+	double delta = config.MaxInitialDecay - config.MinInitialDecay;
 
 	return min + (delta * r);
 }
 
-int GenerateInitialRestCount(const nNodeNetworkConfig &config) {
+int GenerateInitialRestCount(const nNodeNetworkConfig &config, const nRandom& random, int networkId) {
 	if (config.MaxRestCount == config.MinRestCount)
 		return config.MaxRestCount;
 
 	int delta = config.MaxRestCount - config.MinRestCount;
-	delta = rand() % delta;
+	delta = random.GetIndex(nRandomStream::RestCount, networkId, delta);
 
 	return config.MinRestCount + delta;
 }
 
-nNodeNetwork::nNodeNetwork(const vector<int>& layerCounts, const ISensor& sensor)
-	: nNodeNetwork::nNodeNetwork(layerCounts, sensor, DefaultConfig)
+int nNetwork::ReserveGlobalIds(int count)
+{
+	static atomic<int> s_nextGlobalId{ 0 };
+	return s_nextGlobalId.fetch_add(count);
+}
+
+template <class V>
+nBasicNodeNetwork<V>::nBasicNodeNetwork(const vector<int>& layerCounts, const ISensor& sensor)
+	: nBasicNodeNetwork(layerCounts, sensor, DefaultConfig)
 {
 }
 
-nNodeNetwork::nNodeNetwork(const vector<int>& layerCounts, const ISensor& sensor, const nNodeNetworkConfig& config)
+template <class V>
+nBasicNodeNetwork<V>::nBasicNodeNetwork(const vector<int>& layerCounts, const ISensor& sensor, const nNodeNetworkConfig& config)
 	: m_sensor{ sensor }
 	, m_config{ config }
 	, m_nextNetworkId{ 0 }
 	, m_tickCount{ 0 }
+	, m_pOwnedArena{ m_config.pArena ? nullptr : make_unique<nArena>() }
+	, m_pArena{ m_config.pArena ? m_config.pArena : m_pOwnedArena.get() }
+	, m_nodes{ m_pArena }
+	, m_synapses{ m_pArena }
 	// Construct a new nNodeNetwork
 {
 	BuildNetwork(layerCounts, sensor);
 }
 
-nNodeNetwork::~nNodeNetwork() 
-	// release the nodes in m_layers.
+template <class V>
+nBasicNodeNetwork<V>::nBasicNodeNetwork(const nBasicNodeNetwork<V>& source, const nBasicNetworkState<V>& state)
+	: m_config{ source.m_config }
+	, m_sensor{ source.m_sensor }
+	, m_nextNetworkId{ source.m_nextNetworkId }
+	, m_random{ source.m_random }
+	, m_tickCount{ 0 }
+	, m_pOwnedArena{ make_unique<nArena>() }
+	, m_pArena{ m_pOwnedArena.get() }
+	, m_nodes{ m_pArena }
+	, m_synapses{ m_pArena }
+	, m_senseOffsets{ source.m_senseOffsets }
+	, m_senseLocations{ source.m_senseLocations }
+	, m_sensedValues(source.m_sensedValues.size())
+	// Copy the layout and parameters of source, nothing is regenerated. The current values
+	// and rest counts of source change while it ticks, they are taken from state only.
+	// A snapshot always has an arena of its own, see nNodeNetworkConfig::pArena.
 {
-	for (auto pLayer : m_layers) {
-		if (pLayer) {
-			for (auto pNode : *pLayer)
-				delete pNode;
-			delete pLayer;
+	m_config.pArena = nullptr;
+
+	const auto& nodes    = source.m_nodes;
+	const auto& synapses = source.m_synapses;
+	int         count    = (int)nodes.Decays.size();
+
+	m_pArena->Reserve(GetArenaSize(count, (int)synapses.Targets.size()));
+
+	m_nodes.Decays.assign(nodes.Decays.begin(), nodes.Decays.end());
+	m_nodes.MaxRestCounts.assign(nodes.MaxRestCounts.begin(), nodes.MaxRestCounts.end());
+	m_nodes.LayerOffsets = nodes.LayerOffsets;
+	m_nodes.CurrentValues.resize(count);
+	m_nodes.RestCounts.resize(count);
+
+	m_synapses.RowOffsets.assign(synapses.RowOffsets.begin(), synapses.RowOffsets.end());
+	m_synapses.Targets.assign(synapses.Targets.begin(), synapses.Targets.end());
+	m_synapses.Weights.assign(synapses.Weights.begin(), synapses.Weights.end());
+
+	m_globalIdBase = ReserveGlobalIds(count);
+
+	SetState(state);
+
+	m_spikeQueue.reserve(m_nodes.GetNodeCount());
+
+	if (m_config.TickThreadCount != 1)
+		m_pThreadPool = make_unique<nThreadPool>(m_config.TickThreadCount);
+}
+
+template <class V>
+nBasicNodeNetwork<V>::nBasicNodeNetwork(const nBasicNetworkImage<V>& image, const ISensor& sensor, const nNodeNetworkConfig& config)
+	: m_config{ config }
+	, m_sensor{ sensor }
+	, m_random{ config.Seed }
+	, m_tickCount{ 0 }
+	, m_pOwnedArena{ m_config.pArena ? nullptr : make_unique<nArena>() }
+	, m_pArena{ m_config.pArena ? m_config.pArena : m_pOwnedArena.get() }
+	, m_nodes{ m_pArena }
+	, m_synapses{ m_pArena }
+	// Construct a network from the arrays of image, nothing is generated.
+{
+	CheckImage(image);
+
+	int nodeCount = (int)image.CurrentValues.size();
+
+	m_pArena->Reserve(GetArenaSize(nodeCount, image.Targets.size()));
+
+	m_nodes.CurrentValues.assign(image.CurrentValues.begin(), image.CurrentValues.end());
+	m_nodes.Decays.assign(image.Decays.begin(), image.Decays.end());
+	m_nodes.RestCounts.assign(image.RestCounts.begin(), image.RestCounts.end());
+	m_nodes.MaxRestCounts.assign(image.MaxRestCounts.begin(), image.MaxRestCounts.end());
+
+	for (auto count : image.LayerCounts)
+		m_nodes.LayerOffsets.push_back(m_nodes.LayerOffsets.back() + count);
+
+	m_synapses.RowOffsets.assign(image.RowOffsets.begin(), image.RowOffsets.end());
+	m_synapses.Targets.assign(image.Targets.begin(), image.Targets.end());
+	m_synapses.Weights.assign(image.Weights.begin(), image.Weights.end());
+
+	m_nextNetworkId = nodeCount;
+	m_globalIdBase  = ReserveGlobalIds(nodeCount);
+
+	BuildSenseOffsets(image.LayerCounts[0], sensor);
+	m_sensedValues.resize(image.LayerCounts[0]);
+
+	if (!image.Spikes.empty()) {
+		BuildIncomingSynapses();
+		m_spikes.assign(image.Spikes.begin(), image.Spikes.end());
+	}
+
+	m_spikeQueue.reserve(nodeCount);
+
+	if (m_config.TickThreadCount != 1)
+		m_pThreadPool = make_unique<nThreadPool>(m_config.TickThreadCount);
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::CheckImage(const nBasicNetworkImage<V>& image) const
+	// Reject images that would let a tick index outside the arrays, or that have synapses
+	// a built network cannot have.
+{
+	if (image.LayerCounts.empty())
+		throw "A network image must have at least one layer.";
+
+	// Summed in 64 bits, the row offsets hold nodeCount + 1 entries indexed by int.
+	int64_t total = 0;
+	for (auto count : image.LayerCounts) {
+		if (count <= 0)
+			throw "A network image cannot have an empty layer.";
+		total += count;
+		if (total > INT32_MAX - 1)
+			throw "A network image cannot have more than INT32_MAX - 1 nodes.";
+	}
+
+	int nodeCount = (int)total;
+
+	if (image.CurrentValues.size() != nodeCount || image.Decays.size() != nodeCount ||
+		image.RestCounts.size() != nodeCount || image.MaxRestCounts.size() != nodeCount)
+		throw "The node arrays of the network image do not match its layer counts.";
+
+	if (!image.Spikes.empty() && image.Spikes.size() != nodeCount)
+		throw "The spikes of the network image do not match its layer counts.";
+
+	int synapseCount = image.Targets.size();
+
+	if (image.RowOffsets.size() != nodeCount + 1 || image.Weights.size() != synapseCount ||
+		image.RowOffsets[0] != 0 || image.RowOffsets[nodeCount] != synapseCount)
+		throw "The synapse arrays of the network image are inconsistent.";
+
+	for (int x = 0; x < nodeCount; ++x) {
+		if (image.RowOffsets[x] > image.RowOffsets[x + 1])
+			throw "The synapse arrays of the network image are inconsistent.";
+	}
+
+	// Synapses only connect a layer to the layer above it, which nPropagationMode::Queued
+	// relies on to match Recursive. The result layer has no synapses.
+	int source = 0;
+
+	for (int layer = 0; layer < image.LayerCounts.size(); ++layer) {
+		int topBegin = source + image.LayerCounts[layer];
+		int topEnd   = layer + 1 < image.LayerCounts.size() ? topBegin + image.LayerCounts[layer + 1] : topBegin;
+
+		for (; source < topBegin; ++source) {
+			for (int x = image.RowOffsets[source]; x < image.RowOffsets[source + 1]; ++x) {
+				int target = image.Targets[x];
+
+				if (target < 0 || target >= nodeCount)
+					throw "A synapse of the network image targets a node that does not exist.";
+				if (target < topBegin || target >= topEnd)
+					throw "A synapse of the network image does not target the next layer.";
+			}
 		}
 	}
 }
 
-const ISensor& nNodeNetwork::GetSensor() const {
+template <class V>
+nBasicNetworkImage<V> nBasicNodeNetwork<V>::GetImage(vector<int>& layerCounts) const
+{
+	nBasicNetworkImage<V> image = GetLayoutImage(layerCounts);
+	image.CurrentValues = GetCurrentValues();
+	image.RestCounts    = GetRestCounts();
+	image.Spikes        = { m_spikes.data(), (int)m_spikes.size() };
+	return image;
+}
+
+template <class V>
+nBasicNetworkImage<V> nBasicNodeNetwork<V>::GetImage(vector<int>& layerCounts, const nBasicNetworkState<V>& state) const
+	// Never reads the current values, rest counts or spikes of this network, so another
+	// thread may tick it meanwhile.
+{
+	nBasicNetworkImage<V> image = GetLayoutImage(layerCounts);
+	image.CurrentValues = { state.CurrentValues.data(), (int)state.CurrentValues.size() };
+	image.RestCounts    = { state.RestCounts.data(), (int)state.RestCounts.size() };
+	image.Spikes        = { state.Spikes.data(), (int)state.Spikes.size() };
+	return image;
+}
+
+template <class V>
+nBasicNetworkImage<V> nBasicNodeNetwork<V>::GetLayoutImage(vector<int>& layerCounts) const
+	// Image of the arrays that do not change while the network ticks, the tick state is left
+	// empty.
+{
+	layerCounts = GetLayerCounts();
+
+	nBasicNetworkImage<V> image;
+	image.LayerCounts   = { layerCounts.data(), (int)layerCounts.size() };
+	image.Decays        = { m_nodes.Decays.data(), (int)m_nodes.Decays.size() };
+	image.MaxRestCounts = { m_nodes.MaxRestCounts.data(), (int)m_nodes.MaxRestCounts.size() };
+	image.RowOffsets    = { m_synapses.RowOffsets.data(), (int)m_synapses.RowOffsets.size() };
+	image.Targets       = { m_synapses.Targets.data(), (int)m_synapses.Targets.size() };
+	image.Weights       = { m_synapses.Weights.data(), (int)m_synapses.Weights.size() };
+	return image;
+}
+
+template <class V>
+nBasicNodeNetwork<V>::~nBasicNodeNetwork() 
+{
+}
+
+template <class V>
+const ISensor& nBasicNodeNetwork<V>::GetSensor() const {
 	return m_sensor;
 }
 
-vector<int> nNodeNetwork::GetLayerCounts() const
+template <class V>
+vector<int> nBasicNodeNetwork<V>::GetLayerCounts() const
 {
 	vector<int> result;
-	for (auto layer : m_layers) {
-		result.push_back(layer->size());
+	for (int x = 0; x < m_nodes.GetLayerCount(); ++x) {
+		result.push_back(m_nodes.GetLayerEnd(x) - m_nodes.GetLayerBegin(x));
 	}
-	return std::move(result);
+	return result;
 }
 
-const nNode& nNodeNetwork::GetNodeByGlobalId(int globalId) const
-	// Return the node that has the requested globalId.
+template <class V>
+void nBasicNodeNetwork<V>::CheckNetworkId(int networkId) const
 {
-	for (auto layer : m_layers)
-	{
-		for (auto nNode : *layer)
-		{
-			if (nNode->GetGlobalId() == globalId)
-				return *nNode;
-		}
-	}
+	if (networkId < 0 || networkId >= m_nodes.GetNodeCount())
+		throw "No node with this networkId exists.";
+}
 
-	throw "globalId not found.";
+template <class V>
+void nBasicNodeNetwork<V>::CheckLayer(int layer) const
+{
+	if (layer < 0 || layer >= m_nodes.GetLayerCount())
+		throw "No layer with this index exists.";
 }
 
-const nNode& nNodeNetwork::GetNodeByNetworkId(int networkId) const
-	// Return the node that has the requested networkId.
+template <class V>
+int nBasicNodeNetwork<V>::FindNetworkId(int globalId) const
 {
-	for (auto layer : m_layers)
-	{
-		for (auto nNode : *layer)
-		{
-			if (nNode->GetNetworkId() == networkId)
-				return *nNode;
-		}
-	}
+	int networkId = globalId - m_globalIdBase;
 
-	throw "No node with this networkId exists.";
+	if (networkId < 0 || networkId >= m_nodes.GetNodeCount())
+		return -1;
+
+	return networkId;
 }
 
-nNode& nNodeNetwork::GetMutableNodeByGlobalId(int globalId) const
-	// Return the node with the requested globalId
+template <class V>
+int nBasicNodeNetwork<V>::GetLayerBegin(int layer) const
 {
-	for (auto pLayer : m_layers) {
-		for (auto pNode : *pLayer) {
-			if (pNode->GetGlobalId() == globalId)
-				return *pNode;
-		}
-	}
+	CheckLayer(layer);
+	return m_nodes.GetLayerBegin(layer);
+}
+
+template <class V>
+int nBasicNodeNetwork<V>::GetLayerEnd(int layer) const
+{
+	CheckLayer(layer);
+	return m_nodes.GetLayerEnd(layer);
+}
+
+template <class V>
+nBasicNode<V> nBasicNodeNetwork<V>::GetNodeByGlobalId(int globalId) const
+	// Return the node that has the requested globalId.
+{
+	int networkId = FindNetworkId(globalId);
+
+	if (networkId < 0)
+		throw "globalId not found.";
 
-	throw "No node with this globalId exists.";
+	return nBasicNode<V>{ this, networkId };
 }
 
-nNode& nNodeNetwork::GetMutableNodeByNetworkId(int networkId) const
-// Return the node with the requested networkId
+template <class V>
+nBasicNode<V> nBasicNodeNetwork<V>::GetNodeByNetworkId(int networkId) const
+	// Return the node that has the requested networkId.
 {
-	for (auto pLayer : m_layers) {
-		for (auto pNode : *pLayer)
-			if (pNode->GetNetworkId() == networkId)
-				return *pNode;
-	}
+	CheckNetworkId(networkId);
 
-	throw "No node with this networkId exists.";
+	return nBasicNode<V>{ this, networkId };
 }
 
-void nNodeNetwork::BuildFirstLayer(int count, const ISensor& sensor)
-	// The first layer contains nSensingNodes. 
+template <class V>
+void nBasicNodeNetwork<V>::BuildFirstLayer(int count, const ISensor& sensor)
+	// The first layer contains the sensing nodes. 
 	// All sensing nodes point to the same ISensor, which points to a single ISensable.		
 {	
-	auto newLayer = new vector<nNode*>();
-
 	// Create 'count' new nodes, add them to the new layer.
 	for (int x = 0; x < count; ++x) {
-		auto decay = GenerateInitialDecay(m_config);
-		auto maxRestCount = GenerateInitialRestCount(m_config);
-		newLayer->emplace_back(new nSensingNode(m_nextNetworkId++, decay, maxRestCount, m_config.pSensorLocationMapper(x)));
+		auto decay = (V)GenerateInitialDecay(m_config, m_random, m_nextNetworkId);
+		auto maxRestCount = GenerateInitialRestCount(m_config, m_random, m_nextNetworkId);
+		m_nodes.AddNode(decay, maxRestCount);
+		++m_nextNetworkId;
 	}
 
-	m_layers.push_back(newLayer);
+	m_nodes.CloseLayer();
+
+	BuildSenseOffsets(count, sensor);
+	m_sensedValues.resize(count);
 }
 
-void nNodeNetwork::BuildNextLayer(int count)
+template <class V>
+void nBasicNodeNetwork<V>::BuildSenseOffsets(int count, const ISensor& sensor)
+	// Compile the sense location of every sensing node into a linear offset. The locations
+	// come from the config's SenseGrid when it is enabled, otherwise from
+	// pSensorLocationMapper. The locations the sensor has no offset for are kept in
+	// m_senseLocations.
 {
-	std::vector<nNode*>* layer = new std::vector<nNode*>();
+	const nSenseGrid& grid = m_config.SenseGrid;
+
+	m_senseOffsets.resize(count);
+	m_senseLocations.clear();
+
+	auto compile = [&](int x, const vector<int>& location) {
+		m_senseOffsets[x] = sensor.GetLinearOffset(location);
+		if (m_senseOffsets[x] < 0) {
+			m_senseOffsets[x] = -1;
+			m_senseLocations.resize(count);
+			m_senseLocations[x] = location;
+		}
+	};
 
+	if (grid.Dimensions == 0) {
+		for (int x = 0; x < count; ++x)
+			compile(x, m_config.pSensorLocationMapper(x));
+		return;
+	}
+
+	if (grid.Dimensions > 2 || grid.Columns <= 0)
+		throw "The sense grid must have 1 or 2 dimensions and at least one column.";
+
+	vector<int> location(grid.Dimensions);
+
+	for (int x = 0; x < count; ++x) {
+		if (grid.Dimensions == 1) {
+			location[0] = grid.OriginX + x * grid.StrideX;
+		}
+		else {
+			location[0] = grid.OriginX + (x % grid.Columns) * grid.StrideX;
+			location[1] = grid.OriginY + (x / grid.Columns) * grid.StrideY;
+		}
+		compile(x, location);
+	}
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::BuildNextLayer(int count)
+{
 	for (int x = 0; x < count; ++x) {
-		auto decay = GenerateInitialDecay(m_config);
-		auto maxRestCount = GenerateInitialRestCount(m_config);
-		layer->push_back(new nNode(m_nextNetworkId++, decay, maxRestCount));
+		auto decay = (V)GenerateInitialDecay(m_config, m_random, m_nextNetworkId);
+		auto maxRestCount = GenerateInitialRestCount(m_config, m_random, m_nextNetworkId);
+		m_nodes.AddNode(decay, maxRestCount);
+		++m_nextNetworkId;
 	}
 
-	m_layers.push_back(layer);
+	m_nodes.CloseLayer();
 }
 
-void nNodeNetwork::BuildNetwork(const vector<int>& layerCounts, const ISensor& sensor)
+template <class V>
+void nBasicNodeNetwork<V>::BuildNetwork(const vector<int>& layerCounts, const ISensor& sensor)
 	// Builds the network. 
-	// The first layer is a layer of nSensingNodes, while all other layers are built using regular
-	// nNode objects.
+	// The first layer is a layer of sensing nodes, while all other layers are built using
+	// regular nodes.
 {
+	int nodeCount = 0;
+	for (auto count : layerCounts)
+		nodeCount += count;
+
+	int synapseCount = EstimateSynapseCount(layerCounts);
+
+	m_pArena->Reserve(GetArenaSize(nodeCount, synapseCount));
+	m_nodes.Reserve(nodeCount);
+	m_globalIdBase = ReserveGlobalIds(nodeCount);
+	m_random       = nRandom{ m_config.Seed ? m_config.Seed : nRandom::NextSeed() };
+
+	if (m_config.TickThreadCount != 1)
+		m_pThreadPool = make_unique<nThreadPool>(m_config.TickThreadCount);
+
 	BuildFirstLayer(layerCounts[0], sensor);
 
 	for (uint32_t x = 1; x < layerCounts.size(); ++x)
 		BuildNextLayer(layerCounts[x]);
 
-	CopySensingLayer();
-	CopyResultNode();
+	BuildSynapses(synapseCount);
 
-	BuildSynapses();
+	m_spikeQueue.reserve(nodeCount);
 }
 
-void nNodeNetwork::CopySensingLayer() 
-	// The m_sensingLayer member keeps a vector of pointers to the sensing nodes.
+template <class V>
+void nBasicNodeNetwork<V>::ParallelFor(int count, const function<void(int, int)>& fn)
+	// Run fn over [0, count) on the thread pool, or on the calling thread when there is none.
 {
-	m_sensingLayer.clear();
+	if (m_pThreadPool)
+		m_pThreadPool->ParallelFor(count, m_config.TickChunkSize, fn);
+	else if (count)
+		fn(0, count);
+}
+
+template <class V>
+int nBasicNodeNetwork<V>::EstimateSynapseCount(const vector<int>& layerCounts) const
+	// The synapse count of a network with layerCounts, exact for Full and FixedFanOut layers.
+	// Probability layers count their expected synapses plus four standard deviations, receptive
+	// field layers a full field for every top node.
+{
+	double count = 0;
+
+	for (size_t x = 0; x + 1 < layerCounts.size(); ++x) {
+		const nConnectivityProfile& profile = GetConnectivity((int)x);
+		double bottomCount = layerCounts[x];
+		double topCount    = layerCounts[x + 1];
+		double full        = bottomCount * topCount;
+
+		switch (profile.Type) {
+		case nConnectivity::Full:
+			count += full;
+			break;
+
+		case nConnectivity::FixedFanOut:
+			count += bottomCount * min((double)max(profile.FanOut, 0), topCount);
+			break;
+
+		case nConnectivity::Probability: {
+			double p = min(max(profile.Probability, 0.0), 1.0);
+			count += min(full, ceil(full * p + 4 * sqrt(full * p * (1 - p))));
+			break;
+		}
 
-	for (auto pNode : *(m_layers.front())) {
-		m_sensingLayer.push_back(dynamic_cast<nSensingNode*>(pNode));
+		case nConnectivity::ReceptiveField: {
+			double side = 2.0 * max(profile.FieldRadius, 0) + 1;
+			count += min(full, topCount * side * side);
+			break;
+		}
+		}
 	}
 
+	return (int)min(count, (double)INT_MAX);
 }
 
-void nNodeNetwork::CopyResultNode()
-	// m_pResultNode keeps a pointer to the node at the top of network for convenience.
+template <class V>
+size_t nBasicNodeNetwork<V>::GetArenaSize(int nodeCount, int synapseCount)
+	// The four node arrays, the row offsets and the two synapse arrays, each padded for
+	// alignment.
 {
-	m_pResultNode = m_layers.back()->back();
+	return (size_t)nodeCount * (2 * sizeof(V) + 2 * sizeof(int))
+		+ ((size_t)nodeCount + 1) * sizeof(int)
+		+ (size_t)synapseCount * (sizeof(int) + sizeof(V))
+		+ 7 * alignof(max_align_t);
 }
 
-void nNodeNetwork::BuildSynapses() const {
-	for (unsigned int x = 0; x < m_layers.size() - 1; ++x) {
-		BuildLayerSynapses(m_layers[x], m_layers[x + 1]);
+template <class V>
+void nBasicNodeNetwork<V>::BuildSynapses(int synapseCount)
+	// Build the CSR rows layer by layer, following the connectivity profile of each pair of
+	// layers. Only the synapses that exist are generated, so time and memory scale with the
+	// synapse count. The result layer has no synapses.
+	// synapseCount is reserved up front, so the synapse arrays are allocated once unless a
+	// Probability layer draws more synapses than estimated.
+{
+	int nodeCount = m_nodes.GetNodeCount();
+	int lastLayer = m_nodes.GetLayerCount() - 1;
+
+	m_synapses.RowOffsets.assign(nodeCount + 1, 0);
+	m_synapses.Targets.clear();
+	m_synapses.Weights.clear();
+	m_synapses.Targets.reserve(synapseCount);
+	m_synapses.Weights.reserve(synapseCount);
+
+	for (int x = 0; x < lastLayer; ++x) {
+		BuildLayerSynapses(x, x + 1);
 	}
+
+	for (int x = m_nodes.GetLayerBegin(lastLayer); x < m_nodes.GetLayerEnd(lastLayer); ++x)
+		m_synapses.RowOffsets[x + 1] = m_synapses.GetSynapseCount();
 }
 
-void nNodeNetwork::BuildLayerSynapses(const vector<nNode*>* const bottomLayer, const vector<nNode*>* const topLayer) const
+template <class V>
+const nConnectivityProfile& nBasicNodeNetwork<V>::GetConnectivity(int bottomLayer) const
 {
-	for (auto bottomNode : *bottomLayer) {
-		for (auto topNode : *topLayer) {
-			bottomNode->Synapses.push_back(
-				nSynapse { GenerateInitialWeight(m_config), topNode }
-			);
+	if (bottomLayer < (int)m_config.LayerConnectivity.size())
+		return m_config.LayerConnectivity[bottomLayer];
+	return m_config.Connectivity;
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::BuildLayerSynapses(int bottomLayer, int topLayer)
+	// Append the CSR rows of every node in bottomLayer, targets in ascending order within each
+	// row. The rows are sized first, then filled on the thread pool. Every random value is
+	// keyed by the node or synapse it belongs to, so the result does not depend on the order
+	// in which rows are filled.
+{
+	const nConnectivityProfile& profile = GetConnectivity(bottomLayer);
+
+	int bottomBegin = m_nodes.GetLayerBegin(bottomLayer);
+	int bottomCount = m_nodes.GetLayerEnd(bottomLayer) - bottomBegin;
+	int topBegin    = m_nodes.GetLayerBegin(topLayer);
+	int topCount    = m_nodes.GetLayerEnd(topLayer) - topBegin;
+
+	// RowOffsets[bottomBegin] is the end of the previous layer's rows, the sizes of this
+	// layer's rows go into the entries after it and are then summed up.
+	int* pRowOffsets = m_synapses.RowOffsets.data() + bottomBegin;
+
+	switch (profile.Type)
+	{
+	case nConnectivity::Full:
+		for (int x = 0; x < bottomCount; ++x)
+			pRowOffsets[x + 1] = topCount;
+		break;
+
+	case nConnectivity::FixedFanOut:
+		if (profile.FanOut < 1)
+			throw "A fixed fan out connectivity needs a FanOut of at least 1.";
+		for (int x = 0; x < bottomCount; ++x)
+			pRowOffsets[x + 1] = min(profile.FanOut, topCount);
+		break;
+
+	case nConnectivity::Probability:
+		if (!(profile.Probability > 0 && profile.Probability <= 1))
+			throw "A probability connectivity needs a Probability in (0, 1].";
+		ParallelFor(bottomCount, [&](int begin, int end) {
+			for (int x = begin; x < end; ++x)
+				pRowOffsets[x + 1] = WalkProbabilityRow(bottomBegin + x, topBegin, topCount, profile.Probability, nullptr);
+		});
+		break;
+
+	case nConnectivity::ReceptiveField:
+		if (profile.FieldRadius < 0 || profile.FieldColumns < 0)
+			throw "A receptive field connectivity needs a FieldRadius and FieldColumns of at least 0.";
+		BuildReceptiveFieldSynapses(bottomLayer, topLayer, profile.FieldRadius);
+		break;
+	}
+
+	if (profile.Type != nConnectivity::ReceptiveField) {
+		for (int x = 0; x < bottomCount; ++x)
+			pRowOffsets[x + 1] += pRowOffsets[x];
+
+		m_synapses.Targets.resize(pRowOffsets[bottomCount]);
+
+		ParallelFor(bottomCount, [&](int begin, int end) {
+			for (int x = begin; x < end; ++x) {
+				int* pTargets = m_synapses.Targets.data() + pRowOffsets[x];
+
+				switch (profile.Type)
+				{
+				case nConnectivity::Full:
+					for (int y = 0; y < topCount; ++y)
+						pTargets[y] = topBegin + y;
+					break;
+
+				case nConnectivity::FixedFanOut:
+					FillFixedFanOutRow(bottomBegin + x, topBegin, topCount, pRowOffsets[x + 1] - pRowOffsets[x]);
+					break;
+
+				default:
+					WalkProbabilityRow(bottomBegin + x, topBegin, topCount, profile.Probability, pTargets);
+					break;
+				}
+			}
+		});
+	}
+
+	m_synapses.Weights.resize(m_synapses.Targets.size());
+
+	ParallelFor(bottomCount, [&](int begin, int end) {
+		for (int x = begin; x < end; ++x) {
+			for (int y = pRowOffsets[x]; y < pRowOffsets[x + 1]; ++y)
+				m_synapses.Weights[y] = (V)GenerateInitialWeight(m_config, m_random, bottomBegin + x, m_synapses.Targets[y]);
 		}
+	});
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::FillFixedFanOutRow(int bottomNode, int topBegin, int topCount, int fanOut)
+	// Pick fanOut distinct targets for bottomNode with Floyd's algorithm, keeping the row
+	// sorted as it grows.
+{
+	int* pTargets = m_synapses.Targets.data() + m_synapses.RowOffsets[bottomNode];
+	int  size     = 0;
+
+	for (int x = topCount - fanOut; x < topCount; ++x) {
+		int pick = topBegin + m_random.GetIndex(nRandomStream::Target, nRandom::Pair(bottomNode, x), x + 1);
+		if (find(pTargets, pTargets + size, pick) != pTargets + size)
+			pick = topBegin + x;
+
+		int* pSlot = upper_bound(pTargets, pTargets + size, pick);
+		copy_backward(pSlot, pTargets + size, pTargets + size + 1);
+		*pSlot = pick;
+		++size;
 	}
 }
 
-void nNodeNetwork::ForEach(std::function<void(const nNode&)> fn) const {
-	for (auto pLayer : m_layers)
-		for (auto pNode : *pLayer)
-			fn(*pNode);
+template <class V>
+int nBasicNodeNetwork<V>::WalkProbabilityRow(int bottomNode, int topBegin, int topCount, double probability, int* pTargets) const
+	// Walk the possible targets of bottomNode with geometrically distributed gaps, so only the
+	// synapses that exist cost anything. Stores the targets in pTargets unless it is null, and
+	// returns how many there are.
+{
+	double logMiss = probability < 1 ? log(1 - probability) : 0;
+	int    count   = 0;
+
+	for (double target = -1; ; ++count) {
+		// Number of targets skipped before the next synapse.
+		double gap = probability < 1 ? floor(log(1 - m_random.GetUniform(nRandomStream::Gap, nRandom::Pair(bottomNode, count))) / logMiss) : 0;
+
+		target += gap + 1;
+		if (target >= topCount)
+			return count;
+
+		if (pTargets)
+			pTargets[count] = topBegin + (int)target;
+	}
 }
 
-unique_ptr<nNodeNetwork> nNodeNetwork::GetSnapShot() const
-	// Make a copy of the network in its current state. The result is a completely new
-	// network that is owned by the caller.
+template <class V>
+int nBasicNodeNetwork<V>::GetLayerColumns(int layer) const
+	// Width of layer when it is laid out as a 2D grid, see nConnectivityProfile.
 {
-	auto result = make_unique<nNodeNetwork>(GetLayerCounts(), m_sensor);	
+	int count = m_nodes.GetLayerEnd(layer) - m_nodes.GetLayerBegin(layer);
 
-	for (auto layer : m_layers)
-	{
-		for (auto node : *layer)
-		{
-			const nNode& sourceNode = GetNodeByNetworkId(node->GetNetworkId());
-			nNode& destNode = result->GetMutableNodeByNetworkId(node->GetNetworkId());
+	if (layer == 0)
+		return m_config.SenseGrid.Dimensions == 2 ? min(count, m_config.SenseGrid.Columns) : count;
+
+	const nConnectivityProfile& profile = GetConnectivity(layer - 1);
+	if (profile.Type != nConnectivity::ReceptiveField)
+		return count;
+	if (profile.FieldColumns > 0)
+		return min(count, profile.FieldColumns);
 
-			destNode.SetCurrentValue(sourceNode.GetCurrentValue());
+	int bottomCount   = m_nodes.GetLayerEnd(layer - 1) - m_nodes.GetLayerBegin(layer - 1);
+	int bottomColumns = GetLayerColumns(layer - 1);
+	int bottomRows    = (bottomCount + bottomColumns - 1) / bottomColumns;
 
-			for (int x = 0; x != sourceNode.Synapses.size(); x++) 
-			{
-				destNode.Synapses[x].weight = sourceNode.Synapses[x].weight;
-				
+	return max(1, min(count, (int)lround(sqrt((double)count * bottomColumns / bottomRows))));
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::BuildReceptiveFieldSynapses(int bottomLayer, int topLayer, int radius)
+	// Each top node is mapped to the centre of its position in the bottom grid and receives the
+	// bottom nodes around it. The synapses are counted per bottom node first, then filled in, so
+	// the rows come out in target order without sorting. Fills the row offsets and targets, the
+	// weights are left to BuildLayerSynapses.
+{
+	int bottomBegin   = m_nodes.GetLayerBegin(bottomLayer);
+	int bottomCount   = m_nodes.GetLayerEnd(bottomLayer) - bottomBegin;
+	int bottomColumns = GetLayerColumns(bottomLayer);
+	int bottomRows    = (bottomCount + bottomColumns - 1) / bottomColumns;
+
+	int topBegin   = m_nodes.GetLayerBegin(topLayer);
+	int topCount   = m_nodes.GetLayerEnd(topLayer) - topBegin;
+	int topColumns = GetLayerColumns(topLayer);
+	int topRows    = (topCount + topColumns - 1) / topColumns;
+
+	// Calls fn(bottom index) for every bottom node in the field of top node.
+	auto ForField = [&](int top, const function<void(int)>& fn) {
+		int centerX = (int)(((2LL * (top % topColumns) + 1) * bottomColumns) / (2LL * topColumns));
+		int centerY = (int)(((2LL * (top / topColumns) + 1) * bottomRows) / (2LL * topRows));
+
+		for (int y = max(0, centerY - radius); y <= min(bottomRows - 1, centerY + radius); ++y) {
+			for (int x = max(0, centerX - radius); x <= min(bottomColumns - 1, centerX + radius); ++x) {
+				int bottom = y * bottomColumns + x;
+				if (bottom < bottomCount)
+					fn(bottom);
 			}
 		}
+	};
+
+	vector<int> rowSizes(bottomCount, 0);
+	for (int top = 0; top < topCount; ++top)
+		ForField(top, [&rowSizes](int bottom) { ++rowSizes[bottom]; });
+
+	size_t first = m_synapses.Targets.size();
+	vector<size_t> next(bottomCount);
+	for (int bottom = 0; bottom < bottomCount; ++bottom) {
+		next[bottom] = bottom ? next[bottom - 1] + rowSizes[bottom - 1] : first;
+		m_synapses.RowOffsets[bottomBegin + bottom + 1] = (int)(next[bottom] + rowSizes[bottom]);
 	}
 
-	return result;
+	m_synapses.Targets.resize(first + (bottomCount ? next[bottomCount - 1] - first + rowSizes[bottomCount - 1] : 0));
+
+	for (int top = 0; top < topCount; ++top)
+		ForField(top, [&](int bottom) { m_synapses.Targets[next[bottom]++] = topBegin + top; });
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::ForEach(std::function<void(const nBasicNode<V>&)> fn) const {
+	for (int x = 0; x < m_nodes.GetNodeCount(); ++x)
+		fn(nBasicNode<V>{ this, x });
 }
 
-void nNodeNetwork::Tick()
-// Call nNode.Tick() on each node that is stored in the m_layers vector.
+template <class V>
+unique_ptr<nBasicNodeNetwork<V>> nBasicNodeNetwork<V>::GetSnapShot() const
+	// Make a copy of the network in its current state. The result is a completely new
+	// network that is owned by the caller.
 {
-	SenseTick();
-	NodeTick();
+	nBasicNetworkState<V> state;
+	GetState(state);
+	return GetSnapShot(state);
+}
+
+template <class V>
+unique_ptr<nBasicNodeNetwork<V>> nBasicNodeNetwork<V>::GetSnapShot(const nBasicNetworkState<V>& state) const
+	// Make a copy of the network with its tick state taken from state, which must come from
+	// GetState on this network. Only the layout, parameters and weights of this network are
+	// read, never its current values, rest counts or spikes, so another thread may tick it
+	// meanwhile.
+{
+	return unique_ptr<nBasicNodeNetwork<V>>(new nBasicNodeNetwork<V>(*this, state));
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::GetSnapShot(nBasicNodeNetwork<V>& destination) const
+{
+	CheckSameLayout(destination);
+
+	auto& nodes = destination.m_nodes;
+	nodes.CurrentValues.assign(m_nodes.CurrentValues.begin(), m_nodes.CurrentValues.end());
+	nodes.Decays.assign(m_nodes.Decays.begin(), m_nodes.Decays.end());
+	nodes.RestCounts.assign(m_nodes.RestCounts.begin(), m_nodes.RestCounts.end());
+	nodes.MaxRestCounts.assign(m_nodes.MaxRestCounts.begin(), m_nodes.MaxRestCounts.end());
+
+	destination.m_synapses.Weights.assign(m_synapses.Weights.begin(), m_synapses.Weights.end());
+
+	if (m_incoming.IsBuilt()) {
+		if (!destination.m_incoming.IsBuilt())
+			destination.BuildIncomingSynapses();
+		destination.m_spikes.assign(m_spikes.begin(), m_spikes.end());
+	}
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::GetState(nBasicNetworkState<V>& state) const
+{
+	state.CurrentValues.assign(m_nodes.CurrentValues.begin(), m_nodes.CurrentValues.end());
+	state.RestCounts.assign(m_nodes.RestCounts.begin(), m_nodes.RestCounts.end());
+	state.Spikes.assign(m_spikes.begin(), m_spikes.end());
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::SetState(const nBasicNetworkState<V>& state)
+{
+	if ((int)state.CurrentValues.size() != m_nodes.GetNodeCount() || state.RestCounts.size() != state.CurrentValues.size())
+		throw "The state does not match the layout of the network.";
+
+	m_nodes.CurrentValues.assign(state.CurrentValues.begin(), state.CurrentValues.end());
+	m_nodes.RestCounts.assign(state.RestCounts.begin(), state.RestCounts.end());
+
+	// Spikes waiting for the next synchronous tick are part of the state.
+	if (!state.Spikes.empty()) {
+		if (!m_incoming.IsBuilt())
+			BuildIncomingSynapses();
+		m_spikes.assign(state.Spikes.begin(), state.Spikes.end());
+	}
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::CheckSameLayout(const nBasicNodeNetwork<V>& other) const
+{
+	if (other.m_nodes.LayerOffsets != m_nodes.LayerOffsets || other.m_synapses.RowOffsets != m_synapses.RowOffsets)
+		throw "The networks do not have the same layout.";
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::Tick()
+{
+	TickWith(&nBasicNodeNetwork<V>::SenseRange<ISensor>);
 }
 
-void nNodeNetwork::SenseTick()
-// Call Sense on all of the sensing nodes.
+template <class V>
+void nBasicNodeNetwork<V>::TickWith(nSenseRangeFn senseRange)
+// Sense, then decay every node in the network.
+// In synchronous mode the spikes of the previous tick are delivered first, and the spikes fired
+// during this tick become the ones delivered by the next.
 {
-	for (auto pNode : m_sensingLayer)
-		pNode->Sense(m_sensor);
+	bool synchronous = m_config.PropagationMode == nPropagationMode::Synchronous;
+
+#if N_TICK_METRICS
+	// Sensing fires and SenseTick's phases are counted by SenseTick, the cascade of the other
+	// modes by Fire and ActivateFromSynapse.
+	bool metrics = m_config.CollectTickMetrics;
+	if (metrics) {
+		m_tickMetrics       = nTickMetrics{};
+		m_tickMetrics.Ticks = 1;
+		if (synchronous)
+			CountSynchronousActivations();
+	}
+	uint64_t start = metrics ? GetTickMetricsClock() : 0;
+#endif
+
+	if (synchronous)
+		SynchronousTick();
+
+#if N_TICK_METRICS
+	if (metrics)
+		m_tickMetrics.CascadeNanoseconds += GetTickMetricsClock() - start;
+#endif
+
+	SenseTick(senseRange);
+
+#if N_TICK_METRICS
+	start = metrics ? GetTickMetricsClock() : 0;
+#endif
+
+	NodeTick();
+
+#if N_TICK_METRICS
+	if (metrics) {
+		m_tickMetrics.DecayNanoseconds += GetTickMetricsClock() - start;
+		PublishTickMetrics();
+	}
+#endif
+
+	if (synchronous)
+		m_spikes.swap(m_nextSpikes);
 }
 
-void nNodeNetwork::NodeTick()
-// Call tick on all nodes.
+#if N_TICK_METRICS
+
+template <class V>
+void nBasicNodeNetwork<V>::PublishTickMetrics()
+	// In synchronous mode m_nextSpikes flags every node that fired during this tick.
 {
-	for (auto pLayer : m_layers)
-		for (auto pNode : *pLayer)
-			pNode->Tick();
+	if (m_config.PropagationMode == nPropagationMode::Synchronous) {
+		for (auto spike : m_nextSpikes)
+			m_tickMetrics.Fired += spike;
+	}
+
+	m_totalMetrics.Add(m_tickMetrics);
+	m_metricsBoard.Publish(m_tickMetrics, m_totalMetrics);
 }
 
+#endif
+
 #ifdef __DEBUG__
 
-nNode* nNodeNetwork::GetResultNode() {
-	return m_pResultNode;
+template <class V>
+nBasicNode<V> nBasicNodeNetwork<V>::GetResultNode() const {
+	return nBasicNode<V>{ this, m_nodes.GetNodeCount() - 1 };
 }
 
-vector<nSensingNode*>* nNodeNetwork::GetSensingNodes() {
-	return &m_sensingLayer;
+template <class V>
+vector<nBasicSensingNode<V>> nBasicNodeNetwork<V>::GetSensingNodes() const {
+	vector<nBasicSensingNode<V>> result;
+	for (int x = m_nodes.GetLayerBegin(0); x < m_nodes.GetLayerEnd(0); ++x)
+		result.push_back(nBasicSensingNode<V>{ this, x });
+	return result;
 }
 
-vector<nNode*>* nNodeNetwork::GetLayer(int layerIndex) {
-	return m_layers[layerIndex];
+template <class V>
+vector<nBasicNode<V>> nBasicNodeNetwork<V>::GetLayer(int layerIndex) const {
+	vector<nBasicNode<V>> result;
+	for (int x = m_nodes.GetLayerBegin(layerIndex); x < m_nodes.GetLayerEnd(layerIndex); ++x)
+		result.push_back(nBasicNode<V>{ this, x });
+	return result;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+template class nNetwork::nBasicNodeNetwork<double>;
+template class nNetwork::nBasicNodeNetwork<float>;
+template class nNetwork::nBasicNodeNetwork<nFixed16>;
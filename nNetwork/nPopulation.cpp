@@ -0,0 +1,270 @@
+#include "stdafx.h"
+#include "nPopulation.h"
+#include "nThreadPool.h"
+#include "nTickKernels.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace nNetwork;
+
+nPopulation::nPopulation(const vector<int>& layerCounts, const vector<const ISensor*>& sensors, const nNodeNetworkConfig& config)
+	: m_config{ config }
+	, m_sensors{ sensors }
+{
+	vector<unique_ptr<nNodeNetwork>> networks;
+	vector<const nNodeNetwork*>      pNetworks;
+
+	// The members are only built to be packed, they never tick. The population's own thread
+	// pool and arrays are the ones that matter, so the members get neither a pool nor the
+	// caller's arena.
+	nNodeNetworkConfig memberConfig = config;
+	memberConfig.TickThreadCount = 1;
+	memberConfig.pArena          = nullptr;
+
+	for (int member = 0; member < (int)sensors.size(); ++member) {
+		if (config.Seed)
+			memberConfig.Seed = config.Seed + member;
+
+		networks.push_back(make_unique<nNodeNetwork>(layerCounts, *sensors[member], memberConfig));
+		pNetworks.push_back(networks.back().get());
+	}
+
+	Pack(pNetworks);
+}
+
+nPopulation::nPopulation(const vector<const nNodeNetwork*>& networks, const nNodeNetworkConfig& config)
+	: m_config{ config }
+{
+	for (auto pNetwork : networks)
+		m_sensors.push_back(&pNetwork->GetSensor());
+
+	Pack(networks);
+}
+
+nPopulation::~nPopulation()
+{
+}
+
+void nPopulation::Pack(const vector<const nNodeNetwork*>& networks)
+	// Interleave the arrays of the networks, member innermost.
+{
+	if (networks.empty())
+		throw "A population needs at least one member.";
+
+	m_config.PropagationMode = nPropagationMode::Synchronous;
+
+	int memberCount = (int)networks.size();
+
+	vector<int>   layerCounts;
+	nNetworkImage first = networks[0]->GetImage(m_layerCounts);
+
+	m_rowOffsets.assign(first.RowOffsets.begin(), first.RowOffsets.end());
+	m_targets.assign(first.Targets.begin(), first.Targets.end());
+
+	int nodeCount    = GetNodeCount();
+	int synapseCount = GetSynapseCount();
+	int senseCount   = m_layerCounts[0];
+
+	m_currentValues.resize((size_t)nodeCount * memberCount);
+	m_decays.resize((size_t)nodeCount * memberCount);
+	m_restCounts.resize((size_t)nodeCount * memberCount);
+	m_maxRestCounts.resize((size_t)nodeCount * memberCount);
+	m_spikes.assign((size_t)nodeCount * memberCount, 0);
+	m_nextSpikes.assign((size_t)nodeCount * memberCount, 0);
+	m_input.assign((size_t)nodeCount * memberCount, 0);
+	m_weights.resize((size_t)synapseCount * memberCount);
+	m_senseOffsets.resize((size_t)senseCount * memberCount);
+	m_sensedValues.resize((size_t)senseCount * memberCount);
+
+	for (int member = 0; member < memberCount; ++member) {
+		nNetworkImage image = networks[member]->GetImage(layerCounts);
+
+		if (layerCounts != m_layerCounts ||
+			!equal(image.RowOffsets.begin(), image.RowOffsets.end(), m_rowOffsets.begin()) ||
+			!equal(image.Targets.begin(), image.Targets.end(), m_targets.begin()))
+			throw "The members of a population must have the same layout.";
+
+		for (int x = 0; x < nodeCount; ++x) {
+			size_t index = Index(x, member);
+			m_currentValues[index] = image.CurrentValues[x];
+			m_decays[index]        = image.Decays[x];
+			m_restCounts[index]    = image.RestCounts[x];
+			m_maxRestCounts[index] = image.MaxRestCounts[x];
+			if (!image.Spikes.empty())
+				m_spikes[index] = image.Spikes[x] ? (vType)1 : (vType)0;
+		}
+
+		for (int x = 0; x < synapseCount; ++x)
+			m_weights[Index(x, member)] = image.Weights[x];
+
+		auto senseOffsets = networks[member]->GetSenseOffsets();
+		if (any_of(senseOffsets.begin(), senseOffsets.end(), [](int offset) { return offset < 0; }))
+			throw "A population senses through linear offsets, the sensor of a member has none.";
+		copy(senseOffsets.begin(), senseOffsets.end(), m_senseOffsets.begin() + (size_t)member * senseCount);
+	}
+
+	BuildIncomingSynapses();
+
+	if (m_config.TickThreadCount != 1)
+		m_pThreadPool = make_unique<nThreadPool>(m_config.TickThreadCount);
+}
+
+void nPopulation::BuildIncomingSynapses()
+	// Transpose the shared topology, see nNodeNetwork::BuildIncomingSynapses.
+{
+	int nodeCount = GetNodeCount();
+
+	m_incomingOffsets.assign(nodeCount + 1, 0);
+	for (auto target : m_targets)
+		++m_incomingOffsets[target + 1];
+	for (int x = 0; x < nodeCount; ++x)
+		m_incomingOffsets[x + 1] += m_incomingOffsets[x];
+
+	m_incomingSources.resize(m_targets.size());
+	m_incomingSynapses.resize(m_targets.size());
+
+	vector<int> next(m_incomingOffsets.begin(), m_incomingOffsets.end() - 1);
+	for (int source = 0; source < nodeCount; ++source) {
+		for (int synapse = m_rowOffsets[source]; synapse < m_rowOffsets[source + 1]; ++synapse) {
+			int slot = next[m_targets[synapse]]++;
+			m_incomingSources[slot]  = source;
+			m_incomingSynapses[slot] = synapse;
+		}
+	}
+}
+
+unique_ptr<nNodeNetwork> nPopulation::GetMember(int member) const
+{
+	if (member < 0 || member >= GetMemberCount())
+		throw "No member with this index exists.";
+
+	int nodeCount    = GetNodeCount();
+	int synapseCount = GetSynapseCount();
+
+	vector<vType>   currentValues(nodeCount), decays(nodeCount), weights(synapseCount);
+	vector<int>     restCounts(nodeCount), maxRestCounts(nodeCount);
+	vector<uint8_t> spikes(nodeCount);
+
+	for (int x = 0; x < nodeCount; ++x) {
+		size_t index = Index(x, member);
+		currentValues[x] = m_currentValues[index];
+		decays[x]        = m_decays[index];
+		restCounts[x]    = m_restCounts[index];
+		maxRestCounts[x] = m_maxRestCounts[index];
+		spikes[x]        = m_spikes[index] != 0;
+	}
+
+	for (int x = 0; x < synapseCount; ++x)
+		weights[x] = m_weights[Index(x, member)];
+
+	nNetworkImage image;
+	image.LayerCounts   = { m_layerCounts.data(), (int)m_layerCounts.size() };
+	image.CurrentValues = { currentValues.data(), nodeCount };
+	image.Decays        = { decays.data(), nodeCount };
+	image.RestCounts    = { restCounts.data(), nodeCount };
+	image.MaxRestCounts = { maxRestCounts.data(), nodeCount };
+	image.RowOffsets    = { m_rowOffsets.data(), (int)m_rowOffsets.size() };
+	image.Targets       = { m_targets.data(), synapseCount };
+	image.Weights       = { weights.data(), synapseCount };
+	image.Spikes        = { spikes.data(), nodeCount };
+
+	return make_unique<nNodeNetwork>(image, *m_sensors[member], m_config);
+}
+
+/*-------------------------------------------------------------------------------------------------
+	Tick, the same steps as a synchronous nNodeNetwork::Tick.
+-------------------------------------------------------------------------------------------------*/
+
+void nPopulation::Tick()
+{
+	// Chunks cover about TickChunkSize elements: whole nodes of every member, single members for
+	// sensing, and flat element ranges for the decay.
+	int memberCount = GetMemberCount();
+
+	ForRange(GetNodeCount(), max(1, m_config.TickChunkSize / memberCount), &nPopulation::GatherApplyRange);
+	ForRange(memberCount, 1, &nPopulation::SenseRange);
+	ForRange(GetNodeCount() * memberCount, m_config.TickChunkSize, &nPopulation::DecayRange);
+
+	m_spikes.swap(m_nextSpikes);
+}
+
+void nPopulation::ForRange(int count, int chunkSize, void (nPopulation::*pRange)(int, int))
+{
+	if (m_pThreadPool)
+		m_pThreadPool->ParallelFor(count, chunkSize, [this, pRange](int begin, int end) { (this->*pRange)(begin, end); });
+	else
+		(this->*pRange)(0, count);
+}
+
+void nPopulation::GatherApplyRange(int begin, int end)
+	// Deliver the spikes of the previous tick to the targets [begin, end) of every member. Each
+	// target sums its inputs in ascending source order, as nNodeNetwork does; the members whose
+	// source did not fire add weight * 0, which leaves the sum unchanged. The member loops are
+	// branch free so that they vectorise.
+{
+	const int memberCount = GetMemberCount();
+
+	for (int target = begin; target < end; ++target) {
+		vType* pInput = &m_input[Index(target, 0)];
+
+		for (int member = 0; member < memberCount; ++member)
+			pInput[member] = 0;
+
+		for (int x = m_incomingOffsets[target]; x < m_incomingOffsets[target + 1]; ++x) {
+			const vType* pSpikes  = &m_spikes[Index(m_incomingSources[x], 0)];
+			const vType* pWeights = &m_weights[Index(m_incomingSynapses[x], 0)];
+
+			for (int member = 0; member < memberCount; ++member)
+				pInput[member] += pSpikes[member] * pWeights[member];
+		}
+
+		vType*     pValues     = &m_currentValues[Index(target, 0)];
+		int*       pRestCounts = &m_restCounts[Index(target, 0)];
+		const int* pMaxRests   = &m_maxRestCounts[Index(target, 0)];
+		vType*     pNextSpikes = &m_nextSpikes[Index(target, 0)];
+
+		for (int member = 0; member < memberCount; ++member) {
+			bool  active = pRestCounts[member] == 0 && pInput[member] != 0;
+			vType value  = active ? pValues[member] + pInput[member] : pValues[member];
+
+			// Keep the current value clipped to 1.0
+			value = value > 1.0 ? (vType)1.0 : value;
+
+			bool fire = active && value > NODE_TRIGGER_POINT;
+
+			pRestCounts[member] = fire ? pMaxRests[member] : pRestCounts[member];
+			pValues[member]     = fire ? (vType)0 : value;
+			pNextSpikes[member] = fire ? (vType)1 : (vType)0;
+		}
+	}
+}
+
+void nPopulation::SenseRange(int begin, int end)
+	// Sense the members [begin, end), each through its own sensor.
+{
+	const int senseCount = m_layerCounts[0];
+
+	for (int member = begin; member < end; ++member) {
+		vType* pSensed = &m_sensedValues[(size_t)member * senseCount];
+
+		m_sensors[member]->SenseBatch(&m_senseOffsets[(size_t)member * senseCount], senseCount, pSensed);
+
+		for (int x = 0; x < senseCount; ++x) {
+			size_t index = Index(x, member);
+			m_currentValues[index] += pSensed[x];
+
+			// The spike is delivered during the next tick.
+			if (m_currentValues[index] > NODE_TRIGGER_POINT) {
+				m_nextSpikes[index]    = 1;
+				m_currentValues[index] = 0;
+			}
+		}
+	}
+}
+
+void nPopulation::DecayRange(int begin, int end)
+	// The arrays are flat, the decay kernel does not care which member an element belongs to.
+{
+	GetTickKernel()(m_currentValues.data() + begin, m_decays.data() + begin, m_restCounts.data() + begin, end - begin);
+}
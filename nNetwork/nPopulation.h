@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "nNetwork.h"
+
+namespace nNetwork {
+
+	class nThreadPool;
+
+	//++ nPopulation
+	//
+	//+ Purpose:
+	//		Many networks with the same layout, ticked together in lockstep.
+	//
+	//+ Remarks:
+	//		Every member has its own node parameters, weights, state and ISensor, but the members
+	//		share one synapse topology. Per node and per synapse arrays hold one entry per member,
+	//		with the member as the innermost index: element [x * memberCount + member]. A tick is
+	//		then one pass over the topology in which every step updates all members with
+	//		contiguous, vectorisable loops.
+	//
+	//		Members always tick with nPropagationMode::Synchronous semantics, which do not depend
+	//		on the order in which nodes fire, and each member produces bit for bit the results of
+	//		an nNodeNetwork ticked in that mode. The work is split across one thread pool when
+	//		config.TickThreadCount != 1.
+	class nPopulation {
+	public:
+		// Build one random network per sensor, member m senses through *sensors[m]. Member m is
+		// generated exactly as a separate nNodeNetwork with seed config.Seed + m would be, or
+		// with a new seed of its own when config.Seed is 0.
+		nPopulation(const std::vector<int>& layerCounts, const std::vector<const ISensor*>& sensors, const nNodeNetworkConfig& config);
+
+		// Pack existing networks, which must all have the same layout and topology.
+		nPopulation(const std::vector<const nNodeNetwork*>& networks, const nNodeNetworkConfig& config);
+
+		~nPopulation();
+
+		nPopulation(const nPopulation&) = delete;
+		nPopulation& operator=(const nPopulation&) = delete;
+
+		void Tick();
+
+		int GetMemberCount()  const { return (int)m_sensors.size(); }
+		int GetNodeCount()    const { return (int)m_rowOffsets.size() - 1; }
+		int GetSynapseCount() const { return (int)m_targets.size(); }
+
+		vType GetCurrentValue(int member, int networkId) const { return m_currentValues[Index(networkId, member)]; }
+		int   GetRestCount(int member, int networkId)    const { return m_restCounts[Index(networkId, member)]; }
+		vType GetResultValue(int member)                 const { return GetCurrentValue(member, GetNodeCount() - 1); }
+
+		// Synapses are numbered as in nSynapseStore, row by row in source order.
+		vType GetWeight(int member, int synapse) const { return m_weights[Index(synapse, member)]; }
+		void  SetWeight(int member, int synapse, vType weight) { m_weights[Index(synapse, member)] = weight; }
+
+		// Unpack a member into a standalone network.
+		std::unique_ptr<nNodeNetwork> GetMember(int member) const;
+
+	private:
+		nNodeNetworkConfig          m_config;
+		std::vector<const ISensor*> m_sensors;
+		std::vector<int>            m_layerCounts;
+
+		// Shared topology: outgoing CSR and its transpose, ordered by source.
+		std::vector<int> m_rowOffsets;
+		std::vector<int> m_targets;
+		std::vector<int> m_incomingOffsets;
+		std::vector<int> m_incomingSources;
+		std::vector<int> m_incomingSynapses;
+
+		// [x * memberCount + member]
+		std::vector<vType>   m_currentValues;
+		std::vector<vType>   m_decays;
+		std::vector<int>     m_restCounts;
+		std::vector<int>     m_maxRestCounts;
+		std::vector<vType>   m_weights;
+		std::vector<vType>   m_input;
+
+		// 1 for the nodes that fired during the previous tick (m_spikes) and this one
+		// (m_nextSpikes), 0 otherwise. Held as values so that delivery is a multiply add.
+		std::vector<vType>   m_spikes;
+		std::vector<vType>   m_nextSpikes;
+
+		// Sense offsets of member m are [m * sensing node count, (m + 1) * sensing node count),
+		// the sensed values use the same layout.
+		std::vector<int>   m_senseOffsets;
+		std::vector<vType> m_sensedValues;
+
+		std::unique_ptr<nThreadPool> m_pThreadPool;
+
+		size_t Index(int x, int member) const { return (size_t)x * m_sensors.size() + member; }
+
+		void Pack(const std::vector<const nNodeNetwork*>& networks);
+		void BuildIncomingSynapses();
+
+		void ForRange(int count, int chunkSize, void (nPopulation::*pRange)(int, int));
+		void GatherApplyRange(int begin, int end);
+		void SenseRange(int begin, int end);
+		void DecayRange(int begin, int end);
+	};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace nNetwork {
+
+	//++ nRandomStream
+	//
+	//+ Purpose:
+	//		Independent streams of an nRandom, one per kind of generated value.
+	enum class nRandomStream : uint64_t {
+		Decay,
+		RestCount,
+		Weight,
+		Target,
+		Gap
+	};
+
+	//++ nRandom
+	//
+	//+ Purpose:
+	//		Counter based random number generator owned by a network.
+	//
+	//+ Remarks:
+	//		A value is a pure function of the seed, a stream and a 64 bit counter: two SplitMix64
+	//		finalisers, the first keying the stream by the seed, the second mixing in the counter.
+	//		There is no state to advance, so any value can be computed directly, in any order and
+	//		from any number of threads, and the same seed always produces the same network.
+	class nRandom {
+	public:
+		explicit nRandom(uint64_t seed = 0) : m_seed{ seed } {}
+
+		uint64_t GetSeed() const { return m_seed; }
+
+		uint64_t Get(nRandomStream stream, uint64_t counter) const {
+			return Mix(Mix(m_seed ^ ((uint64_t)stream + 1) * 0xD1B54A32D192ED03ull) + counter * 0x9E3779B97F4A7C15ull);
+		}
+
+		// Uniform in [0, 1), with 53 random bits.
+		double GetUniform(nRandomStream stream, uint64_t counter) const {
+			return (double)(Get(stream, counter) >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		// Uniform in [0, count).
+		int GetIndex(nRandomStream stream, uint64_t counter, int count) const {
+			return (int)(((Get(stream, counter) >> 32) * (uint64_t)count) >> 32);
+		}
+
+		// Counter of a value that belongs to a pair of ids, such as the source and target of a
+		// synapse.
+		static uint64_t Pair(int first, int second) { return ((uint64_t)(uint32_t)first << 32) | (uint32_t)second; }
+
+		// A new seed on every call, from a process wide sequence. Thread safe.
+		static uint64_t NextSeed() {
+			static std::atomic<uint64_t> s_nextSeed{ 0 };
+			return Mix(s_nextSeed.fetch_add(1, std::memory_order_relaxed) + 0x5EED);
+		}
+
+	private:
+		uint64_t m_seed;
+
+		static uint64_t Mix(uint64_t z) {
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+	};
+}
@@ -1,16 +1,76 @@
 #include "stdafx.h"
 #include "nNetwork.h"
+#include "nThreadPool.h"
 
 using namespace nNetwork;
 using namespace std;
 
-void nSensingNode::Sense(const ISensor& sensor) {
-	m_currentValue += sensor.Sense(m_senseLocation);
-	if (m_currentValue > NODE_TRIGGER_POINT)
+template <class V>
+int nBasicSensingNode<V>::GetSenseOffset() const {
+	return this->m_pNetwork->m_senseOffsets[this->m_networkId];
+}
+
+template <class V>
+void nBasicNodeNetwork<V>::SenseTick(nSenseRangeFn senseRange)
+	// Sense a value for every node in the sensing layer, through senseRange. A sensing node that crosses
+	// NODE_TRIGGER_POINT activates its synapses.
+	// Spikes never reach the sensing layer, so every sensing node can be sensed first, in
+	// parallel when there is a thread pool, and the nodes that crossed the trigger point are
+	// then propagated in order.
+	// SynchronousTick has already cleared m_nextSpikes for this tick.
+{
+	int count = m_nodes.GetLayerEnd(0);
+
+#if N_TICK_METRICS
+	bool     metrics = m_config.CollectTickMetrics;
+	uint64_t start   = metrics ? GetTickMetricsClock() : 0;
+#endif
+
+	if (m_pThreadPool)
+		m_pThreadPool->ParallelFor(count, m_config.TickChunkSize, [this, senseRange](int begin, int end) { senseRange(*this, begin, end); });
+	else
+		senseRange(*this, 0, count);
+
+#if N_TICK_METRICS
+	uint64_t sensed = metrics ? GetTickMetricsClock() : 0;
+	if (metrics)
+		m_tickMetrics.SenseNanoseconds += sensed - start;
+#endif
+
+	bool synchronous = m_config.PropagationMode == nPropagationMode::Synchronous;
+
+	for (int x = 0; x < count; ++x)
 	{
-		for (auto synapse : Synapses)
-			synapse.pNode->ActivateFromSynapse(synapse);
-		m_currentValue = 0;
+		if (m_nodes.CurrentValues[x] > NODE_TRIGGER_POINT)
+		{
+			// In synchronous mode the spike is delivered during the next tick.
+			if (synchronous)
+				m_nextSpikes[x] = 1;
+			else {
+#if N_TICK_METRICS
+				if (metrics)
+					++m_tickMetrics.Fired;
+#endif
+				Propagate(x);
+			}
+			m_nodes.CurrentValues[x] = 0;
+		}
 	}
+
+#if N_TICK_METRICS
+	if (metrics)
+		m_tickMetrics.CascadeNanoseconds += GetTickMetricsClock() - sensed;
+#endif
 }
 
+template class nNetwork::nBasicSensingNode<double>;
+template class nNetwork::nBasicSensingNode<float>;
+template class nNetwork::nBasicSensingNode<nFixed16>;
+
+// nNodeNetwork.cpp instantiates the nBasicNodeNetwork members it defines, see nNode.cpp.
+#define N_INSTANTIATE_SENSING(V) \
+	template void nNetwork::nBasicNodeNetwork<V>::SenseTick(nSenseRangeFn);
+
+N_INSTANTIATE_SENSING(double)
+N_INSTANTIATE_SENSING(float)
+N_INSTANTIATE_SENSING(nFixed16)
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "nNetwork.h"
+
+namespace nNetwork {
+
+	//++ nStaticLayout
+	//
+	//+ Purpose:
+	//		Compile time layout of an nStaticNetwork with the layer counts Layers.
+	template <int... Layers>
+	struct nStaticLayout {
+		static const int LAYER_COUNT = sizeof...(Layers);
+
+		static constexpr int GetLayerSize(int layer) {
+			const int sizes[] = { Layers... };
+			return sizes[layer];
+		}
+
+		static constexpr int GetLayerBegin(int layer) {
+			int begin = 0;
+			for (int x = 0; x < layer; ++x)
+				begin += GetLayerSize(x);
+			return begin;
+		}
+
+		// First weight of the matrix from layer to layer + 1.
+		static constexpr int GetWeightsBegin(int layer) {
+			int begin = 0;
+			for (int x = 0; x < layer; ++x)
+				begin += GetLayerSize(x) * GetLayerSize(x + 1);
+			return begin;
+		}
+	};
+
+	//++ nStaticNetwork
+	//
+	//+ Purpose:
+	//		A network whose layer counts are template parameters, for small fixed shapes such as
+	//		nStaticNetwork<5, 3, 2, 1>. Every array is a std::array member, nothing is allocated,
+	//		and every loop of a tick has a compile time bound.
+	//
+	//+ Remarks:
+	//		A static network is imported from an nNodeNetwork and ticks exactly as that network
+	//		does with nPropagationMode::Queued (or Recursive, which gives the same results).
+	//		Synapses are stored as one dense weight matrix per pair of adjacent layers; a synapse
+	//		that does not exist in the imported network has a weight of 0, which never changes a
+	//		node value. It never fires a node either, since the import refuses node values above
+	//		the trigger point.
+	//		Spikes travel layer by layer: the frontier of nodes fired in layer l is delivered to
+	//		layer l + 1, which is the order in which the Queued worklist delivers them.
+	template <int... Layers>
+	class nStaticNetwork {
+	public:
+		using Layout = nStaticLayout<Layers...>;
+
+		static const int LAYER_COUNT  = Layout::LAYER_COUNT;
+		static const int NODE_COUNT   = Layout::GetLayerBegin(LAYER_COUNT);
+		static const int WEIGHT_COUNT = Layout::GetWeightsBegin(LAYER_COUNT - 1);
+		static const int SENSE_COUNT  = Layout::GetLayerSize(0);
+
+		static_assert(LAYER_COUNT >= 2, "A static network needs a sensing layer and a result layer.");
+
+		// Copy the parameters, weights and tick state of network, which must have the layer
+		// counts Layers, only synapses from each layer to the next one, rows in ascending
+		// target order and no node above the sensing layer with a value above the trigger
+		// point. The static network senses through network's sensor.
+		explicit nStaticNetwork(const nNodeNetwork& network);
+
+		void Tick() { Tick<ISensor>(); }
+
+		// Tick with the sensor bound statically as a TSensor, see nNodeNetwork::Tick<TSensor>.
+		template <class TSensor>
+		void Tick();
+
+		vType GetCurrentValue(int networkId) const { return m_values[networkId]; }
+		int   GetRestCount(int networkId)    const { return m_restCounts[networkId]; }
+		vType GetResultValue()               const { return m_values[NODE_COUNT - 1]; }
+
+		const std::array<vType, NODE_COUNT>& GetCurrentValues() const { return m_values; }
+
+	private:
+		const ISensor& m_sensor;
+
+		std::array<vType, NODE_COUNT>   m_values{};
+		std::array<vType, NODE_COUNT>   m_decays{};
+		std::array<int, NODE_COUNT>     m_restCounts{};
+		std::array<int, NODE_COUNT>     m_maxRestCounts{};
+		std::array<vType, WEIGHT_COUNT> m_weights{};
+		std::array<int, SENSE_COUNT>    m_senseOffsets{};
+		std::array<vType, SENSE_COUNT>  m_sensed{};
+
+		template <int Layer>
+		struct nLayerTag {};
+
+		// Deliver the spikes of the count nodes of layer Layer in pFrontier, by index within
+		// the layer, then the spikes they cause in the layers above.
+		template <int Layer>
+		void Propagate(const int* pFrontier, int count, nLayerTag<Layer>);
+		void Propagate(const int*, int, nLayerTag<LAYER_COUNT - 1>) {}
+
+		template <class TSensor>
+		void SenseTick();
+		void NodeTick();
+	};
+
+	template <int... Layers>
+	nStaticNetwork<Layers...>::nStaticNetwork(const nNodeNetwork& network)
+		: m_sensor{ network.GetSensor() }
+	{
+		if (network.GetLayerCounts() != std::vector<int>{ Layers... })
+			throw "The network does not have the layer counts of the static network.";
+
+		if (network.GetPropagationMode() == nPropagationMode::Synchronous)
+			throw "A static network ticks with queued propagation.";
+
+		std::vector<int> layerCounts;
+		nNetworkImage    image = network.GetImage(layerCounts);
+
+		for (int x = 0; x < NODE_COUNT; ++x) {
+			m_values[x]        = image.CurrentValues[x];
+			m_decays[x]        = image.Decays[x];
+			m_restCounts[x]    = image.RestCounts[x];
+			m_maxRestCounts[x] = image.MaxRestCounts[x];
+
+			// Above the sensing layer a node at this value would fire on the weight 0 of a
+			// missing synapse. A ticked network never holds one, it resets the nodes that fire.
+			if (x >= SENSE_COUNT && m_values[x] > NODE_TRIGGER_POINT)
+				throw "A static network cannot import a node value above the trigger point.";
+		}
+
+		for (int x = 0; x < SENSE_COUNT; ++x) {
+			m_senseOffsets[x] = network.GetSenseOffsets()[x];
+			if (m_senseOffsets[x] < 0)
+				throw "A static network senses through linear offsets, the sensor has none.";
+		}
+
+		for (int layer = 0; layer < LAYER_COUNT; ++layer) {
+			int begin    = Layout::GetLayerBegin(layer);
+			int topBegin = Layout::GetLayerBegin(layer + 1);
+			int topEnd   = topBegin + (layer + 1 < LAYER_COUNT ? Layout::GetLayerSize(layer + 1) : 0);
+
+			for (int source = begin; source < topBegin; ++source) {
+				int previous = -1;
+
+				for (int x = image.RowOffsets[source]; x < image.RowOffsets[source + 1]; ++x) {
+					int target = image.Targets[x];
+
+					if (target < topBegin || target >= topEnd)
+						throw "A static network only has synapses from each layer to the next one.";
+					if (target <= previous)
+						throw "A static network needs the synapses of each node in ascending target order.";
+					previous = target;
+
+					m_weights[Layout::GetWeightsBegin(layer) + (source - begin) * Layout::GetLayerSize(layer + 1) + (target - topBegin)] = image.Weights[x];
+				}
+			}
+		}
+	}
+
+	template <int... Layers>
+	template <class TSensor>
+	void nStaticNetwork<Layers...>::Tick()
+		// Sense, then decay every node, as nNodeNetwork::Tick does.
+	{
+		assert(dynamic_cast<const TSensor*>(&m_sensor));
+
+		SenseTick<TSensor>();
+		NodeTick();
+	}
+
+	template <int... Layers>
+	template <class TSensor>
+	void nStaticNetwork<Layers...>::SenseTick()
+		// Sense every sensing node first, then propagate the ones that crossed the trigger point
+		// in order, see nNodeNetwork::SenseTick.
+	{
+		static_cast<const TSensor&>(m_sensor).SenseBatch(m_senseOffsets.data(), SENSE_COUNT, m_sensed.data());
+
+		for (int x = 0; x < SENSE_COUNT; ++x)
+			m_values[x] += m_sensed[x];
+
+		for (int x = 0; x < SENSE_COUNT; ++x) {
+			if (m_values[x] > NODE_TRIGGER_POINT) {
+				Propagate(&x, 1, nLayerTag<0>{});
+				m_values[x] = 0;
+			}
+		}
+	}
+
+	template <int... Layers>
+	template <int Layer>
+	void nStaticNetwork<Layers...>::Propagate(const int* pFrontier, int count, nLayerTag<Layer>)
+		// Activate the synapses of every frontier node, see nNodeNetwork::ActivateFromSynapse
+		// and nNodeNetwork::Fire. The nodes of layer Layer + 1 that fire form the next frontier.
+	{
+		constexpr int topSize  = Layout::GetLayerSize(Layer + 1);
+		constexpr int topBegin = Layout::GetLayerBegin(Layer + 1);
+
+		int next[topSize];
+		int nextCount = 0;
+
+		for (int x = 0; x < count; ++x) {
+			const vType* pWeights = m_weights.data() + Layout::GetWeightsBegin(Layer) + pFrontier[x] * topSize;
+
+			for (int y = 0; y < topSize; ++y) {
+				int target = topBegin + y;
+
+				if (m_restCounts[target])
+					continue;
+
+				vType& value = m_values[target];
+
+				value += pWeights[y];
+
+				// Keep the current value clipped to 1.0
+				if (value > 1.0)
+					value = 1.0;
+
+				if (value > NODE_TRIGGER_POINT) {
+					next[nextCount++] = y;
+					m_restCounts[target] = m_maxRestCounts[target];
+					value = 0;
+				}
+			}
+		}
+
+		if (nextCount)
+			Propagate(next, nextCount, nLayerTag<Layer + 1>{});
+	}
+
+	template <int... Layers>
+	void nStaticNetwork<Layers...>::NodeTick()
+		// Decay every node and count down the rest counts, as the scalar tick kernel does.
+	{
+		for (int x = 0; x < NODE_COUNT; ++x) {
+			m_values[x] -= m_decays[x];
+			if (m_values[x] < 0)
+				m_values[x] = 0;
+
+			if (m_restCounts[x])
+				--m_restCounts[x];
+		}
+	}
+}
@@ -0,0 +1,144 @@
+#include "stdafx.h"
+#include "nThreadPool.h"
+
+using namespace std;
+using namespace nNetwork;
+
+nThreadPool::nThreadPool(int threadCount)
+{
+	if (threadCount <= 0)
+		threadCount = (int)thread::hardware_concurrency();
+	if (threadCount <= 0)
+		threadCount = 1;
+
+	for (int x = 0; x < threadCount; ++x)
+		m_queues.push_back(make_unique<nWorkQueue>());
+
+	for (int x = 1; x < threadCount; ++x)
+		m_workers.emplace_back(&nThreadPool::WorkerLoop, this, x);
+}
+
+nThreadPool::~nThreadPool()
+{
+	{
+		lock_guard<mutex> lock{ m_wakeLock };
+		m_exit = true;
+	}
+	m_wake.notify_all();
+
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void nThreadPool::ParallelFor(int count, int chunkSize, const function<void(int, int)>& fn)
+{
+	if (count <= 0)
+		return;
+
+	if (chunkSize <= 0)
+		chunkSize = 1;
+
+	// Not worth waking anybody up.
+	if (m_workers.empty() || count <= chunkSize) {
+		fn(0, count);
+		return;
+	}
+
+	lock_guard<mutex> dispatch{ m_dispatchLock };
+
+	int chunkCount     = (count + chunkSize - 1) / chunkSize;
+	int queueCount     = GetThreadCount();
+	int chunksPerQueue = (chunkCount + queueCount - 1) / queueCount;
+
+	m_pending.store(chunkCount, memory_order_relaxed);
+
+	// Each queue gets a contiguous block of chunks so that, without stealing, every
+	// participant sweeps one contiguous range of the arrays.
+	for (int chunk = 0; chunk < chunkCount; ++chunk) {
+		int begin = chunk * chunkSize;
+		int end   = begin + chunkSize < count ? begin + chunkSize : count;
+
+		nWorkQueue& queue = *m_queues[chunk / chunksPerQueue];
+		lock_guard<mutex> lock{ queue.Lock };
+		queue.Chunks.push_back(nChunk{ &fn, begin, end });
+	}
+
+	{
+		lock_guard<mutex> lock{ m_wakeLock };
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	RunChunks(0);
+
+	unique_lock<mutex> lock{ m_doneLock };
+	m_done.wait(lock, [this] { return m_pending.load(memory_order_acquire) == 0; });
+}
+
+void nThreadPool::WorkerLoop(int queueIndex)
+{
+	uint64_t seenGeneration = 0;
+
+	for (;;)
+	{
+		{
+			unique_lock<mutex> lock{ m_wakeLock };
+			m_wake.wait(lock, [&] { return m_exit || m_generation != seenGeneration; });
+			if (m_exit)
+				return;
+			seenGeneration = m_generation;
+		}
+
+		RunChunks(queueIndex);
+	}
+}
+
+void nThreadPool::RunChunks(int queueIndex)
+	// Run chunks from our own queue first, then steal until every queue is empty.
+{
+	nChunk chunk;
+
+	while (TryPop(queueIndex, chunk) || TrySteal(queueIndex, chunk))
+	{
+		(*chunk.pFn)(chunk.Begin, chunk.End);
+
+		if (m_pending.fetch_sub(1, memory_order_acq_rel) == 1) {
+			lock_guard<mutex> lock{ m_doneLock };
+			m_done.notify_all();
+		}
+	}
+}
+
+bool nThreadPool::TryPop(int queueIndex, nChunk& chunk)
+	// The owner takes chunks from the front of its queue, in array order.
+{
+	nWorkQueue& queue = *m_queues[queueIndex];
+	lock_guard<mutex> lock{ queue.Lock };
+
+	if (queue.Chunks.empty())
+		return false;
+
+	chunk = queue.Chunks.front();
+	queue.Chunks.pop_front();
+	return true;
+}
+
+bool nThreadPool::TrySteal(int queueIndex, nChunk& chunk)
+	// Thieves take chunks from the back of the other queues, away from the owner.
+{
+	int queueCount = GetThreadCount();
+
+	for (int offset = 1; offset < queueCount; ++offset)
+	{
+		nWorkQueue& queue = *m_queues[(queueIndex + offset) % queueCount];
+		lock_guard<mutex> lock{ queue.Lock };
+
+		if (!queue.Chunks.empty()) {
+			chunk = queue.Chunks.back();
+			queue.Chunks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
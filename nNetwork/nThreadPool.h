@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace nNetwork {
+
+	//++ nThreadPool
+	//
+	//+ Purpose:
+	//		Persistent pool of worker threads that runs data parallel loops.
+	//
+	//+ Remarks:
+	//		ParallelFor splits [0, count) into chunks and hands each participant (the workers and
+	//		the calling thread) a contiguous block of chunks. A participant that runs out of work
+	//		steals chunks from the back of another participant's queue. The workers sleep between
+	//		calls, so the pool can be kept for the lifetime of a network.
+	//		Only one ParallelFor runs at a time, concurrent callers are serialised.
+	class nThreadPool {
+	public:
+		// threadCount includes the thread that calls ParallelFor. 0 uses every hardware thread.
+		explicit nThreadPool(int threadCount);
+		~nThreadPool();
+
+		nThreadPool(const nThreadPool&) = delete;
+		nThreadPool& operator=(const nThreadPool&) = delete;
+
+		int GetThreadCount() const { return (int)m_queues.size(); }
+
+		// Call fn(begin, end) for chunks of at most chunkSize indices covering [0, count), and
+		// return once every chunk has completed. fn must not throw.
+		void ParallelFor(int count, int chunkSize, const std::function<void(int, int)>& fn);
+
+	private:
+		struct nChunk {
+			const std::function<void(int, int)>* pFn;
+			int Begin;
+			int End;
+		};
+
+		struct nWorkQueue {
+			std::mutex         Lock;
+			std::deque<nChunk> Chunks;
+		};
+
+		// One queue per participant, queue 0 belongs to the thread calling ParallelFor.
+		std::vector<std::unique_ptr<nWorkQueue>> m_queues;
+		std::vector<std::thread>                 m_workers;
+
+		std::mutex              m_dispatchLock;
+
+		std::mutex              m_wakeLock;
+		std::condition_variable m_wake;
+		uint64_t                m_generation{ 0 };
+		bool                    m_exit{ false };
+
+		std::atomic<int>        m_pending{ 0 };
+		std::mutex              m_doneLock;
+		std::condition_variable m_done;
+
+		void WorkerLoop(int queueIndex);
+		void RunChunks(int queueIndex);
+		bool TryPop(int queueIndex, nChunk& chunk);
+		bool TrySteal(int queueIndex, nChunk& chunk);
+	};
+}
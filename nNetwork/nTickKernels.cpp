@@ -0,0 +1,236 @@
+#include "stdafx.h"
+#include "nTickKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define N_TICK_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC lets any function use any intrinsic, gcc and clang need each kernel to opt in to the
+// instruction set that it uses.
+#if defined(N_TICK_X86) && !defined(_MSC_VER)
+#define N_TARGET(isa) __attribute__((target(isa)))
+#else
+#define N_TARGET(isa)
+#endif
+
+using namespace nNetwork;
+
+namespace {
+
+	/*---------------------------------------------------------------------------------------------
+		Kernels. All of them handle the tail that does not fill a whole vector with the scalar
+		loop.
+
+		The clamp is done with a compare and mask rather than max(value, 0): max(-0.0, 0.0)
+		returns +0.0, while the scalar "if (value < 0) value = 0" leaves -0.0 alone.
+	---------------------------------------------------------------------------------------------*/
+
+	void ScalarTick(vType* pValues, const vType* pDecays, int* pRestCounts, int begin, int count)
+	{
+		for (int x = begin; x < count; ++x)
+		{
+			pValues[x] -= pDecays[x];
+			if (pValues[x] < 0)
+				pValues[x] = 0;
+
+			if (pRestCounts[x])
+				--pRestCounts[x];
+		}
+	}
+
+	void ScalarTickKernel(vType* pValues, const vType* pDecays, int* pRestCounts, int count)
+	{
+		ScalarTick(pValues, pDecays, pRestCounts, 0, count);
+	}
+
+#ifdef N_TICK_X86
+
+	static_assert(sizeof(vType) == sizeof(double), "The SIMD tick kernels are written for double node values.");
+
+	N_TARGET("sse2")
+	void SSE2TickKernel(vType* pValues, const vType* pDecays, int* pRestCounts, int count)
+		// 4 nodes per iteration: two vectors of values, one of rest counts.
+	{
+		const __m128d zero  = _mm_setzero_pd();
+		const __m128i zeroi = _mm_setzero_si128();
+		const __m128i one   = _mm_set1_epi32(1);
+
+		int x = 0;
+		for (; x + 4 <= count; x += 4)
+		{
+			__m128d v0 = _mm_sub_pd(_mm_loadu_pd(pValues + x),     _mm_loadu_pd(pDecays + x));
+			__m128d v1 = _mm_sub_pd(_mm_loadu_pd(pValues + x + 2), _mm_loadu_pd(pDecays + x + 2));
+			_mm_storeu_pd(pValues + x,     _mm_andnot_pd(_mm_cmplt_pd(v0, zero), v0));
+			_mm_storeu_pd(pValues + x + 2, _mm_andnot_pd(_mm_cmplt_pd(v1, zero), v1));
+
+			// rest - 1 - (rest == 0 ? -1 : 0) decrements only the non zero counts.
+			__m128i r = _mm_loadu_si128((const __m128i*)(pRestCounts + x));
+			r = _mm_sub_epi32(_mm_sub_epi32(r, one), _mm_cmpeq_epi32(r, zeroi));
+			_mm_storeu_si128((__m128i*)(pRestCounts + x), r);
+		}
+
+		ScalarTick(pValues, pDecays, pRestCounts, x, count);
+	}
+
+	N_TARGET("avx2")
+	void AVX2TickKernel(vType* pValues, const vType* pDecays, int* pRestCounts, int count)
+		// 8 nodes per iteration.
+	{
+		const __m256d zero  = _mm256_setzero_pd();
+		const __m256i zeroi = _mm256_setzero_si256();
+		const __m256i one   = _mm256_set1_epi32(1);
+
+		int x = 0;
+		for (; x + 8 <= count; x += 8)
+		{
+			__m256d v0 = _mm256_sub_pd(_mm256_loadu_pd(pValues + x),     _mm256_loadu_pd(pDecays + x));
+			__m256d v1 = _mm256_sub_pd(_mm256_loadu_pd(pValues + x + 4), _mm256_loadu_pd(pDecays + x + 4));
+			_mm256_storeu_pd(pValues + x,     _mm256_andnot_pd(_mm256_cmp_pd(v0, zero, _CMP_LT_OQ), v0));
+			_mm256_storeu_pd(pValues + x + 4, _mm256_andnot_pd(_mm256_cmp_pd(v1, zero, _CMP_LT_OQ), v1));
+
+			__m256i r = _mm256_loadu_si256((const __m256i*)(pRestCounts + x));
+			r = _mm256_sub_epi32(_mm256_sub_epi32(r, one), _mm256_cmpeq_epi32(r, zeroi));
+			_mm256_storeu_si256((__m256i*)(pRestCounts + x), r);
+		}
+
+		ScalarTick(pValues, pDecays, pRestCounts, x, count);
+	}
+
+	N_TARGET("avx512f")
+	void AVX512TickKernel(vType* pValues, const vType* pDecays, int* pRestCounts, int count)
+		// 16 nodes per iteration, the clamp and the decrement use mask registers.
+	{
+		const __m512d zero  = _mm512_setzero_pd();
+		const __m512i zeroi = _mm512_setzero_si512();
+		const __m512i one   = _mm512_set1_epi32(1);
+
+		int x = 0;
+		for (; x + 16 <= count; x += 16)
+		{
+			__m512d v0 = _mm512_sub_pd(_mm512_loadu_pd(pValues + x),     _mm512_loadu_pd(pDecays + x));
+			__m512d v1 = _mm512_sub_pd(_mm512_loadu_pd(pValues + x + 8), _mm512_loadu_pd(pDecays + x + 8));
+			_mm512_storeu_pd(pValues + x,     _mm512_mask_mov_pd(v0, _mm512_cmp_pd_mask(v0, zero, _CMP_LT_OQ), zero));
+			_mm512_storeu_pd(pValues + x + 8, _mm512_mask_mov_pd(v1, _mm512_cmp_pd_mask(v1, zero, _CMP_LT_OQ), zero));
+
+			__m512i r = _mm512_loadu_si512((const void*)(pRestCounts + x));
+			r = _mm512_mask_sub_epi32(r, _mm512_cmpneq_epi32_mask(r, zeroi), r, one);
+			_mm512_storeu_si512((void*)(pRestCounts + x), r);
+		}
+
+		ScalarTick(pValues, pDecays, pRestCounts, x, count);
+	}
+
+	/*---------------------------------------------------------------------------------------------
+		CPU feature detection.
+	---------------------------------------------------------------------------------------------*/
+
+	struct nCpuFeatures {
+		bool SSE2{ false };
+		bool AVX2{ false };
+		bool AVX512F{ false };
+	};
+
+	nCpuFeatures DetectCpuFeatures()
+	{
+		nCpuFeatures features;
+
+#ifdef _MSC_VER
+		int info[4];
+
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		features.SSE2 = (info[3] & (1 << 26)) != 0;
+
+		// AVX state has to be enabled by the OS (OSXSAVE + XCR0) before the wide registers can
+		// be used.
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		bool ymmState = (xcr0 & 0x06) == 0x06;
+		bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+		if (maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			features.AVX2    = ymmState && (info[1] & (1 << 5)) != 0;
+			features.AVX512F = zmmState && (info[1] & (1 << 16)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		features.SSE2    = __builtin_cpu_supports("sse2");
+		features.AVX2    = __builtin_cpu_supports("avx2");
+		features.AVX512F = __builtin_cpu_supports("avx512f");
+#endif
+
+		return features;
+	}
+
+	const nCpuFeatures& GetCpuFeatures()
+	{
+		static const nCpuFeatures features = DetectCpuFeatures();
+		return features;
+	}
+
+#endif // N_TICK_X86
+}
+
+bool nNetwork::IsTickIsaSupported(nTickIsa isa)
+{
+	switch (isa)
+	{
+	case nTickIsa::Scalar: return true;
+#ifdef N_TICK_X86
+	case nTickIsa::SSE2:   return GetCpuFeatures().SSE2;
+	case nTickIsa::AVX2:   return GetCpuFeatures().AVX2;
+	case nTickIsa::AVX512: return GetCpuFeatures().AVX512F;
+#endif
+	default:               return false;
+	}
+}
+
+nTickIsa nNetwork::GetBestTickIsa()
+{
+	static const nTickIsa best =
+		IsTickIsaSupported(nTickIsa::AVX512) ? nTickIsa::AVX512 :
+		IsTickIsaSupported(nTickIsa::AVX2)   ? nTickIsa::AVX2   :
+		IsTickIsaSupported(nTickIsa::SSE2)   ? nTickIsa::SSE2   :
+		                                       nTickIsa::Scalar;
+	return best;
+}
+
+nTickKernel nNetwork::GetTickKernel(nTickIsa isa)
+{
+	if (!IsTickIsaSupported(isa))
+		throw "The requested instruction set is not supported by this CPU.";
+
+	switch (isa)
+	{
+#ifdef N_TICK_X86
+	case nTickIsa::SSE2:   return SSE2TickKernel;
+	case nTickIsa::AVX2:   return AVX2TickKernel;
+	case nTickIsa::AVX512: return AVX512TickKernel;
+#endif
+	default:               return ScalarTickKernel;
+	}
+}
+
+nTickKernel nNetwork::GetTickKernel()
+{
+	static const nTickKernel kernel = GetTickKernel(GetBestTickIsa());
+	return kernel;
+}
+
+const char* nNetwork::GetTickIsaName(nTickIsa isa)
+{
+	switch (isa)
+	{
+	case nTickIsa::SSE2:   return "SSE2";
+	case nTickIsa::AVX2:   return "AVX2";
+	case nTickIsa::AVX512: return "AVX-512";
+	default:               return "Scalar";
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "nNetwork.h"
+
+namespace nNetwork {
+
+	//++ nTickIsa
+	//
+	//+ Purpose:
+	//		Instruction sets that a tick kernel can be built for.
+	enum class nTickIsa {
+		Scalar,
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	//++ nTickKernel
+	//
+	//+ Purpose:
+	//		Decays count nodes: each value is reduced by its decay and clamped to 0, each non zero
+	//		rest count is decremented. Every kernel produces bit for bit the same results as the
+	//		Scalar kernel.
+	using nTickKernel = void(*)(vType* pValues, const vType* pDecays, int* pRestCounts, int count);
+
+	// True if the CPU (and OS) running the process can execute kernels built for isa.
+	bool IsTickIsaSupported(nTickIsa isa);
+
+	// The widest instruction set supported at runtime. Evaluated once, on first use.
+	nTickIsa GetBestTickIsa();
+
+	// The kernel built for isa. isa must be supported.
+	nTickKernel GetTickKernel(nTickIsa isa);
+
+	// The kernel used by nNodeNetwork::NodeTick, GetTickKernel(GetBestTickIsa()).
+	nTickKernel GetTickKernel();
+
+	const char* GetTickIsaName(nTickIsa isa);
+
+	// Tick count nodes of a network of any value type with the scalar algorithm. Networks of
+	// vType use the overload below, which runs GetTickKernel().
+	template <class V>
+	void TickNodes(V* pValues, const V* pDecays, int* pRestCounts, int count)
+	{
+		for (int x = 0; x < count; ++x)
+		{
+			pValues[x] -= pDecays[x];
+			if (pValues[x] < (V)0)
+				pValues[x] = (V)0;
+
+			if (pRestCounts[x])
+				--pRestCounts[x];
+		}
+	}
+
+	inline void TickNodes(vType* pValues, const vType* pDecays, int* pRestCounts, int count)
+	{
+		GetTickKernel()(pValues, pDecays, pRestCounts, count);
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Tick metrics, see nTickMetrics. Define N_TICK_METRICS as 0 to compile them out of
+// nNodeNetwork, nothing is then counted or timed.
+#ifndef N_TICK_METRICS
+#define N_TICK_METRICS 1
+#endif
+
+namespace nNetwork {
+
+	//++ nTickMetrics
+	//
+	//+ Purpose:
+	//		What a network did during one tick, or in total over the ticks it has counted.
+	//
+	//+ Remarks:
+	//		Fired counts every node that fired, sensing nodes included. An activation is one
+	//		synapse delivering a spike; it is absorbed when its target is resting and ignores it.
+	//		SenseNanoseconds covers reading the sensor, CascadeNanoseconds the propagation of the
+	//		spikes of the sensing nodes (or, in synchronous mode, the delivery of the spikes of
+	//		the previous tick) and DecayNanoseconds the node sweep.
+	struct nTickMetrics {
+		uint64_t Ticks{ 0 };
+		uint64_t Fired{ 0 };
+		uint64_t Activations{ 0 };
+		uint64_t AbsorbedActivations{ 0 };
+		uint64_t SenseNanoseconds{ 0 };
+		uint64_t CascadeNanoseconds{ 0 };
+		uint64_t DecayNanoseconds{ 0 };
+
+		static const int FIELD_COUNT = 7;
+
+		void Add(const nTickMetrics& other) {
+			Ticks               += other.Ticks;
+			Fired               += other.Fired;
+			Activations         += other.Activations;
+			AbsorbedActivations += other.AbsorbedActivations;
+			SenseNanoseconds    += other.SenseNanoseconds;
+			CascadeNanoseconds  += other.CascadeNanoseconds;
+			DecayNanoseconds    += other.DecayNanoseconds;
+		}
+	};
+
+	// Nanoseconds on a steady clock, read by the phase timers.
+	inline uint64_t GetTickMetricsClock() {
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static_assert(sizeof(nTickMetrics) == nTickMetrics::FIELD_COUNT * sizeof(uint64_t), "nTickMetricsBoard copies FIELD_COUNT uint64_t fields of nTickMetrics.");
+
+	//++ nTickMetricsBoard
+	//
+	//+ Purpose:
+	//		Hands the metrics of a network from the thread that ticks it to any number of reader
+	//		threads, without a lock.
+	//
+	//+ Remarks:
+	//		A sequence lock: Publish makes the sequence odd, stores every value and makes it even
+	//		again. Read copies the values and retries when the sequence was odd or moved during
+	//		the copy, so the writer never waits and a reader always gets the values of a single
+	//		Publish. Only one thread may publish at a time.
+	class nTickMetricsBoard {
+	public:
+		nTickMetricsBoard() : m_sequence{ 0 } {
+			for (auto& value : m_values)
+				value.store(0, std::memory_order_relaxed);
+		}
+
+		nTickMetricsBoard(const nTickMetricsBoard&) = delete;
+		nTickMetricsBoard& operator=(const nTickMetricsBoard&) = delete;
+
+		void Publish(const nTickMetrics& lastTick, const nTickMetrics& total) {
+			uint64_t values[VALUE_COUNT];
+			Pack(lastTick, values);
+			Pack(total, values + nTickMetrics::FIELD_COUNT);
+
+			uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+			m_sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			for (int x = 0; x < VALUE_COUNT; ++x)
+				m_values[x].store(values[x], std::memory_order_relaxed);
+
+			m_sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		void Read(nTickMetrics& lastTick, nTickMetrics& total) const {
+			uint64_t values[VALUE_COUNT];
+			uint32_t before, after;
+
+			do {
+				before = m_sequence.load(std::memory_order_acquire);
+
+				for (int x = 0; x < VALUE_COUNT; ++x)
+					values[x] = m_values[x].load(std::memory_order_relaxed);
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				after = m_sequence.load(std::memory_order_relaxed);
+			} while ((before & 1) || before != after);
+
+			Unpack(values, lastTick);
+			Unpack(values + nTickMetrics::FIELD_COUNT, total);
+		}
+
+	private:
+		static const int VALUE_COUNT = 2 * nTickMetrics::FIELD_COUNT;
+
+		std::atomic<uint32_t> m_sequence;
+		std::atomic<uint64_t> m_values[VALUE_COUNT];
+
+		// Copy the FIELD_COUNT fields of metrics to and from pValues, in declaration order.
+		static void Pack(const nTickMetrics& metrics, uint64_t* pValues) {
+			pValues[0] = metrics.Ticks;
+			pValues[1] = metrics.Fired;
+			pValues[2] = metrics.Activations;
+			pValues[3] = metrics.AbsorbedActivations;
+			pValues[4] = metrics.SenseNanoseconds;
+			pValues[5] = metrics.CascadeNanoseconds;
+			pValues[6] = metrics.DecayNanoseconds;
+		}
+
+		static void Unpack(const uint64_t* pValues, nTickMetrics& metrics) {
+			metrics.Ticks               = pValues[0];
+			metrics.Fired               = pValues[1];
+			metrics.Activations         = pValues[2];
+			metrics.AbsorbedActivations = pValues[3];
+			metrics.SenseNanoseconds    = pValues[4];
+			metrics.CascadeNanoseconds  = pValues[5];
+			metrics.DecayNanoseconds    = pValues[6];
+		}
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+
+namespace nNetwork {
+
+	//++ nTripleBuffer
+	//
+	//+ Purpose:
+	//		Hands values from one writer thread to one reader thread without either of them ever
+	//		waiting for the other.
+	//
+	//+ Remarks:
+	//		There are three slots. The writer owns the back slot and the reader owns the front
+	//		slot; the third, the middle slot, holds the most recently published value. Publish
+	//		swaps the back slot with the middle slot and Acquire swaps the middle slot with the
+	//		front slot, each with a single atomic exchange. A reader that calls Acquire twice
+	//		without a Publish in between keeps its front slot.
+	//		Only one thread may write and only one thread may read at a time; callers serialise
+	//		several readers themselves.
+	template <class T>
+	class nTripleBuffer {
+	public:
+		nTripleBuffer() : m_back{ 0 }, m_middle{ 1 }, m_front{ 2 } {}
+
+		nTripleBuffer(const nTripleBuffer&) = delete;
+		nTripleBuffer& operator=(const nTripleBuffer&) = delete;
+
+		// Writer side: fill GetBack(), then Publish it.
+		T& GetBack() { return m_slots[m_back]; }
+
+		void Publish() {
+			m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+		}
+
+		// Reader side: the most recently published value. Returns false, and leaves the front
+		// slot alone, when nothing was published since the last call.
+		bool Acquire() {
+			if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+				return false;
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+			return true;
+		}
+
+		const T& GetFront() const { return m_slots[m_front]; }
+
+	private:
+		static const int INDEX = 3;
+		static const int FRESH = 4;
+
+		T                m_slots[3];
+		int              m_back;
+		std::atomic<int> m_middle;
+		int              m_front;
+	};
+}
@@ -0,0 +1,178 @@
+#include "Checkpoint.h"
+#include "NetworkFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace nNetwork;
+
+namespace {
+
+	string GetPath(const nCheckpointConfig& config, const string& fileName)
+	{
+		return config.Directory + "/" + fileName;
+	}
+
+#ifdef _WIN32
+
+	void SyncFile(const string& path)
+	{
+		HANDLE hFile = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			throw "Unable to open the checkpoint to flush it.";
+		BOOL flushed = FlushFileBuffers(hFile);
+		CloseHandle(hFile);
+		if (!flushed)
+			throw "Unable to flush the checkpoint.";
+	}
+
+	// Windows has no way to flush a directory, MoveFileEx with MOVEFILE_WRITE_THROUGH is used
+	// instead.
+	void SyncDirectory(const string&) {}
+
+	void ReplaceFile(const string& from, const string& to)
+	{
+		if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+			throw "Unable to move the checkpoint into place.";
+	}
+
+#else
+
+	void SyncFile(const string& path)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw "Unable to open the checkpoint to flush it.";
+		int result = fsync(fd);
+		close(fd);
+		if (result != 0)
+			throw "Unable to flush the checkpoint.";
+	}
+
+	void SyncDirectory(const string& directory)
+	{
+		int fd = open(directory.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw "Unable to open the checkpoint directory to flush it.";
+		fsync(fd);
+		close(fd);
+	}
+
+	void ReplaceFile(const string& from, const string& to)
+	{
+		if (rename(from.c_str(), to.c_str()) != 0)
+			throw "Unable to move the checkpoint into place.";
+	}
+
+#endif
+}
+
+/*-------------------------------------------------------------------------------------------------
+	nCheckpointer
+-------------------------------------------------------------------------------------------------*/
+
+nCheckpointer::nCheckpointer(const nExecuter& executer, const nCheckpointConfig& config)
+	: m_executer{ executer }
+	, m_config{ config }
+{
+	if (m_config.Retention < 1 || m_config.IntervalMilliseconds < 1)
+		throw "A checkpoint config needs a retention and an interval of at least 1.";
+
+	m_thread = thread(&nCheckpointer::Run, this);
+}
+
+nCheckpointer::~nCheckpointer()
+{
+	{
+		lock_guard<mutex> lock{ m_lock };
+		m_exit = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+void nCheckpointer::Run()
+	// Checkpoint every IntervalMilliseconds. Errors are not thrown across the thread, the next
+	// interval simply tries again.
+{
+	unique_lock<mutex> lock{ m_lock };
+
+	while (!m_wake.wait_for(lock, chrono::milliseconds(m_config.IntervalMilliseconds), [this] { return m_exit; })) {
+		lock.unlock();
+		try {
+			Checkpoint();
+		}
+		catch (const char*) {
+		}
+		lock.lock();
+	}
+}
+
+void nCheckpointer::Checkpoint()
+{
+	lock_guard<mutex> lock{ m_checkpointLock };
+
+	auto start = chrono::steady_clock::now();
+
+	nNetworkImage image = m_executer.GetImage(m_state, m_layerCounts);
+
+	// Nothing ran since the last checkpoint.
+	if (m_state.Iteration == m_lastIteration)
+		return;
+
+	int    count    = m_checkpointCount.load();
+	string fileName = m_config.Name + "." + to_string(count % m_config.Retention) + ".nnet";
+	string path     = GetPath(m_config, fileName);
+	string latest   = GetPath(m_config, m_config.Name + ".latest");
+
+	WriteNetworkFile(path + ".tmp", image, m_state.Iteration);
+	if (m_config.Sync != nSyncPolicy::None)
+		SyncFile(path + ".tmp");
+	ReplaceFile(path + ".tmp", path);
+
+	{
+		ofstream out(latest + ".tmp", ios::trunc);
+		out << fileName;
+		if (!out)
+			throw "Unable to write the checkpoint pointer.";
+	}
+	if (m_config.Sync != nSyncPolicy::None)
+		SyncFile(latest + ".tmp");
+	ReplaceFile(latest + ".tmp", latest);
+
+	if (m_config.Sync == nSyncPolicy::FileAndDirectory)
+		SyncDirectory(m_config.Directory);
+
+	m_lastIteration = m_state.Iteration;
+	m_checkpointCount.store(count + 1);
+	m_lastMilliseconds.store(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+}
+
+/*-------------------------------------------------------------------------------------------------
+	Resume
+-------------------------------------------------------------------------------------------------*/
+
+unique_ptr<nExecuter> ResumeExecuter(const nCheckpointConfig& config, const ISensor& sensor, const nNodeNetworkConfig& networkConfig)
+{
+	string fileName;
+	{
+		ifstream in(GetPath(config, config.Name + ".latest"));
+		if (!(in >> fileName))
+			throw "No checkpoint was found.";
+	}
+
+	int  iteration = 0;
+	auto pNetwork  = ReadNetworkFile(GetPath(config, fileName), sensor, networkConfig, &iteration);
+
+	return make_unique<nExecuter>(move(pNetwork), iteration);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "../nNetwork/nNetwork.h"
+
+//++ nSyncPolicy
+//
+//+ Purpose:
+//		How hard a checkpoint is pushed to disk before it counts as written.
+enum class nSyncPolicy {
+	None,				// Leave it to the OS, a power failure may lose recent checkpoints.
+	File,				// Flush every checkpoint file and the pointer to it.
+	FileAndDirectory	// Also flush the directory, so the renames survive a power failure (POSIX).
+};
+
+//++ nCheckpointConfig
+//
+//+ Purpose:
+//		Where and how often an nCheckpointer writes.
+//
+//+ Remarks:
+//		Checkpoints are network files named Directory/Name.<slot>.nnet, the slots are reused
+//		round robin so at most Retention checkpoints exist. Directory/Name.latest holds the
+//		file name of the newest complete checkpoint.
+struct nCheckpointConfig {
+	std::string Directory{ "." };
+	std::string Name{ "network" };
+	int         IntervalMilliseconds{ 60000 };
+	int         Retention{ 2 };
+	nSyncPolicy Sync{ nSyncPolicy::File };
+};
+
+//++ nCheckpointer
+//
+//+ Purpose:
+//		Periodically saves the state of a running nExecuter from a background thread.
+//
+//+ Remarks:
+//		The state is copied from the snapshot the executer publishes (see nExecuter::GetState),
+//		so the tick thread never waits for a checkpoint; its only cost is publishing every
+//		nNodeNetworkConfig::SnapShotInterval ticks. A checkpoint is first written to a temporary
+//		file and then renamed into its slot, the .latest pointer is updated last, so a crash
+//		always leaves the previous checkpoint usable.
+//		The executer must outlive the checkpointer.
+class nCheckpointer {
+public:
+	nCheckpointer(const nNetwork::nExecuter& executer, const nCheckpointConfig& config);
+	~nCheckpointer();
+
+	nCheckpointer(const nCheckpointer&) = delete;
+	nCheckpointer& operator=(const nCheckpointer&) = delete;
+
+	// Write a checkpoint now, on the calling thread.
+	void Checkpoint();
+
+	int    GetCheckpointCount() const { return m_checkpointCount.load(); }
+
+	// Time taken by the last checkpoint, copy and write, in milliseconds.
+	double GetLastCheckpointMilliseconds() const { return m_lastMilliseconds.load(); }
+
+private:
+	const nNetwork::nExecuter& m_executer;
+	nCheckpointConfig          m_config;
+
+	// Reused for every checkpoint, guarded by m_checkpointLock.
+	std::mutex                 m_checkpointLock;
+	nNetwork::nNetworkState    m_state;
+	std::vector<int>           m_layerCounts;
+	int                        m_lastIteration{ -1 };
+
+	std::atomic<int>           m_checkpointCount{ 0 };
+	std::atomic<double>        m_lastMilliseconds{ 0 };
+
+	// Wakes the checkpoint thread early when the checkpointer is destroyed.
+	std::mutex                 m_lock;
+	std::condition_variable    m_wake;
+	bool                       m_exit{ false };
+	std::thread                m_thread;
+
+	void Run();
+};
+
+// Build an executer from the newest checkpoint written with config. The executer is paused and
+// its iteration count continues from the checkpoint.
+std::unique_ptr<nNetwork::nExecuter> ResumeExecuter(const nCheckpointConfig& config, const nNetwork::ISensor& sensor, const nNetwork::nNodeNetworkConfig& networkConfig);
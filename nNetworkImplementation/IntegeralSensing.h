@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <type_traits>
+#include <cstddef>
 #include "../nNetwork/nNetwork.h"
 
 template<typename T>
@@ -24,46 +25,160 @@ public:
 		assert(location.size() == 1);
 		return (T)m_target[location[0]];		
 	}
+
+	virtual int GetLinearOffset(const std::vector<int>& location) const override { return location[0]; }
+
+	virtual void SenseBatch(const int* pOffsets, int count, T* pResults) const override {
+		const T* pTarget = m_target.data();
+		for (int x = 0; x < count; ++x)
+			pResults[x] = pTarget[pOffsets[x]];
+	}
 protected:
 	std::vector<T> m_target;
 };
 
+//++ nTileView
+//
+//+ Purpose:
+//		Read-only, non owning view of a rectangular tile of a strided sensable.
+//
+//+ Remarks:
+//		Strides are in elements. (x, y) is relative to the origin of the tile.
 template<typename T>
-class IntegralSensable2d : public IIntegralSensable<T> {
+struct nTileView {
+	const T*  pData;
+	int       Width;
+	int       Height;
+	ptrdiff_t ColumnStride;
+	ptrdiff_t RowStride;
+
+	T        operator()(int x, int y) const { return pData[x * ColumnStride + y * RowStride]; }
+	const T* GetRow(int y)            const { return pData + y * RowStride; }
+};
+
+//++ IntegralSensableNd
+//
+//+ Purpose:
+//		N dimensional sensable over a single buffer with explicit strides.
+//
+//+ Remarks:
+//		The sensable either owns a contiguous buffer, or is a zero copy view over a buffer that
+//		the caller owns and keeps alive (a camera frame with padded rows, for instance). Strides
+//		are in elements, dimension 1 is x. Linear offsets are element offsets into the buffer,
+//		so SenseBatch is a plain gather.
+template<typename T>
+class IntegralSensableNd : public IIntegralSensable<T> {
 public:
-	IntegralSensable2d(const std::vector<std::vector<T>>& target) : m_target{ target } {
-		m_height = m_target.size();
-		m_width  = m_target[0].size();
+	// Take ownership of a contiguous buffer, row major with dimension 1 varying fastest.
+	IntegralSensableNd(std::vector<T> data, const std::vector<int>& lengths)
+		: m_owned{ std::move(data) }, m_lengths{ lengths }
+	{
+		ptrdiff_t stride = 1;
+		for (auto length : m_lengths) {
+			m_strides.push_back(stride);
+			stride *= length;
+		}
+
+		assert((size_t)stride == m_owned.size());
+		m_pData = m_owned.data();
+	}
 
-		// Assert that all x vectors are of the same width.
-		for (auto v : m_target)
-			assert(v.size() == m_width);
+	// View a buffer owned by the caller, nothing is copied.
+	IntegralSensableNd(const T* pData, const std::vector<int>& lengths, const std::vector<ptrdiff_t>& strides)
+		: m_pData{ pData }, m_lengths{ lengths }, m_strides{ strides }
+	{
+		assert(m_lengths.size() == m_strides.size());
 	}
-	virtual ~IntegralSensable2d() {}
 
-	virtual int GetDimensionCount() const override { return 2; }
-	virtual int GetDimensionLength(int dimension) const override { assert(dimension == 1 || dimension == 2); return dimension == 1 ? m_width : m_height; }
+	virtual ~IntegralSensableNd() {}
+
+	virtual int GetDimensionCount() const override { return (int)m_lengths.size(); }
+	virtual int GetDimensionLength(int dimension) const override {
+		assert(dimension >= 1 && dimension <= (int)m_lengths.size());
+		return m_lengths[dimension - 1];
+	}
 
 	virtual T Sense(const std::vector<int>& location) const override {
-		assert(location.size() == 2);
+		return m_pData[GetLinearOffset(location)];
+	}
+
+	virtual int GetLinearOffset(const std::vector<int>& location) const override {
+		assert(location.size() == m_lengths.size());
+
+		ptrdiff_t offset = 0;
+		for (size_t x = 0; x < location.size(); ++x) {
+			assert(location[x] >= 0 && location[x] < m_lengths[x]);
+			offset += location[x] * m_strides[x];
+		}
+		return (int)offset;
+	}
+
+	virtual void SenseBatch(const int* pOffsets, int count, T* pResults) const override {
+		const T* pData = m_pData;
+		for (int x = 0; x < count; ++x)
+			pResults[x] = pData[pOffsets[x]];
+	}
 
-		int x = location[0];
-		int y = location[1];
+	const T*  GetData()                const { return m_pData; }
+	ptrdiff_t GetStride(int dimension) const { return m_strides[dimension - 1]; }
 
-		assert(x < m_width);
-		assert(y < m_height);
+	// The width x height tile whose origin is (x, y) in the first two dimensions, every other
+	// dimension at 0.
+	nTileView<T> GetTile(int x, int y, int width, int height) const {
+		assert(m_lengths.size() >= 2);
+		assert(x >= 0 && y >= 0 && x + width <= m_lengths[0] && y + height <= m_lengths[1]);
 
-		return (T)m_target[y][x];
+		return nTileView<T>{ m_pData + x * m_strides[0] + y * m_strides[1], width, height, m_strides[0], m_strides[1] };
 	}
 
-	T Sense(int x, int y) { return Sense(std::vector<int>{ x, y }); }
+	// Row y of the first two dimensions.
+	nTileView<T> GetRow(int y) const { return GetTile(0, y, m_lengths[0], 1); }
+
+protected:
+	std::vector<T>         m_owned;
+	const T*               m_pData;
+	std::vector<int>       m_lengths;
+	std::vector<ptrdiff_t> m_strides;
+};
+
+template<typename T>
+class IntegralSensable2d : public IntegralSensableNd<T> {
+public:
+	// The outer vector represents Y, while the inner vector represents X.... The rows are
+	// copied once into a single contiguous buffer.
+	IntegralSensable2d(const std::vector<std::vector<T>>& target)
+		: IntegralSensableNd<T>{ Flatten(target), std::vector<int>{ (int)target[0].size(), (int)target.size() } } {}
+
+	// Zero copy view of a width x height image whose rows are rowStride elements apart.
+	IntegralSensable2d(const T* pData, int width, int height, ptrdiff_t rowStride)
+		: IntegralSensableNd<T>{ pData, std::vector<int>{ width, height }, std::vector<ptrdiff_t>{ 1, rowStride } } {}
+
+	virtual ~IntegralSensable2d() {}
+
+	using IntegralSensableNd<T>::Sense;
+
+	T Sense(int x, int y) const {
+		assert(x < this->m_lengths[0]);
+		assert(y < this->m_lengths[1]);
+
+		return this->m_pData[x * this->m_strides[0] + y * this->m_strides[1]];
+	}
 
 private:
-	// The outer vector represents Y, while the inner vector represents X....
-	// This way the Row data is layed out in contiguous memory.
-	std::vector<std::vector<T>> m_target;
-	int m_height;
-	int m_width;
+	static std::vector<T> Flatten(const std::vector<std::vector<T>>& target) {
+		size_t width = target[0].size();
+
+		std::vector<T> result;
+		result.reserve(width * target.size());
+
+		for (auto& row : target) {
+			// All rows must be of the same width.
+			assert(row.size() == width);
+			result.insert(result.end(), row.begin(), row.end());
+		}
+
+		return result;
+	}
 };
 
 template<typename T>
@@ -74,7 +189,64 @@ public:
 
 	virtual vType Sense(const std::vector<int>& location) const override { return (vType)m_pSensable->Sense(location)/(vType)m_max; }
 
+	virtual int GetLinearOffset(const std::vector<int>& location) const override { return m_pSensable->GetLinearOffset(location); }
+
+	virtual void SenseBatch(const int* pOffsets, int count, vType* pResults) const override {
+		// Sense in chunks through a stack buffer, one virtual call per chunk rather than one
+		// per location.
+		const int chunkSize = 256;
+		T sensed[chunkSize];
+
+		for (int begin = 0; begin < count; begin += chunkSize) {
+			int chunk = count - begin < chunkSize ? count - begin : chunkSize;
+
+			m_pSensable->SenseBatch(pOffsets + begin, chunk, sensed);
+
+			for (int x = 0; x < chunk; ++x)
+				pResults[begin + x] = (vType)sensed[x] / (vType)m_max;
+		}
+	}
+
 protected:
 	IIntegralSensable<T>* m_pSensable;
 	T m_max;
-};
\ No newline at end of file
+};
+//++ BoundIntegralSensor
+//
+//+ Purpose:
+//		IntegralSensor bound at compile time to a sensable of type TSensable.
+//
+//+ Remarks:
+//		The sensable is called as a TSensable rather than through IIntegralSensable<T>, and the
+//		class is final, so nNodeNetwork::Tick<BoundIntegralSensor<T, TSensable>>() inlines the
+//		sensor, the sensable and the normalisation into the sense loop. It is still an ISensor,
+//		Tick() senses through it as it does through any other sensor.
+template<typename T, class TSensable>
+class BoundIntegralSensor final : public nNetwork::ISensor {
+	static_assert(std::is_base_of<IIntegralSensable<T>, TSensable>::value, "TSensable is not an IIntegralSensable<T>");
+public:
+	BoundIntegralSensor(const TSensable* pSensable, T max) : m_pSensable{ pSensable }, m_max{ max } {};
+	virtual ~BoundIntegralSensor() {}
+
+	virtual vType Sense(const std::vector<int>& location) const override { return (vType)m_pSensable->TSensable::Sense(location) / (vType)m_max; }
+
+	virtual int GetLinearOffset(const std::vector<int>& location) const override { return m_pSensable->TSensable::GetLinearOffset(location); }
+
+	virtual void SenseBatch(const int* pOffsets, int count, vType* pResults) const override {
+		const int chunkSize = 256;
+		T sensed[chunkSize];
+
+		for (int begin = 0; begin < count; begin += chunkSize) {
+			int chunk = count - begin < chunkSize ? count - begin : chunkSize;
+
+			m_pSensable->TSensable::SenseBatch(pOffsets + begin, chunk, sensed);
+
+			for (int x = 0; x < chunk; ++x)
+				pResults[begin + x] = (vType)sensed[x] / (vType)m_max;
+		}
+	}
+
+protected:
+	const TSensable* m_pSensable;
+	T m_max;
+};
@@ -0,0 +1,227 @@
+#include "MappedSensing.h"
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/*-------------------------------------------------------------------------------------------------
+	nMappedFile
+-------------------------------------------------------------------------------------------------*/
+
+#ifdef _WIN32
+
+nMappedFile::nMappedFile(const string& path, nMappedAccess access)
+{
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (access == nMappedAccess::Sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	if (access == nMappedAccess::Random)     flags |= FILE_FLAG_RANDOM_ACCESS;
+
+	HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		throw "Unable to open the file to map.";
+	m_hFile = hFile;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size)) {
+		CloseHandle(hFile);
+		throw "Unable to read the size of the file to map.";
+	}
+	m_size = (size_t)size.QuadPart;
+
+	// An empty file cannot be mapped, it is represented by a null view.
+	if (m_size) {
+		m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_hMapping) {
+			CloseHandle(hFile);
+			throw "Unable to map the file.";
+		}
+
+		m_pData = (const unsigned char*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (!m_pData) {
+			CloseHandle(m_hMapping);
+			CloseHandle(hFile);
+			throw "Unable to map the file.";
+		}
+	}
+
+	if (access == nMappedAccess::WillNeed)
+		Advise(access);
+}
+
+nMappedFile::~nMappedFile()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+	if (m_hMapping)
+		CloseHandle(m_hMapping);
+	if (m_hFile)
+		CloseHandle(m_hFile);
+}
+
+void nMappedFile::Advise(nMappedAccess access) const
+	// Windows only takes sequential/random hints when the file is opened, WillNeed prefetches
+	// the whole view.
+{
+#if _WIN32_WINNT >= 0x0602
+	if (access == nMappedAccess::WillNeed && m_pData) {
+		WIN32_MEMORY_RANGE_ENTRY range{ (PVOID)m_pData, m_size };
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#endif
+}
+
+#else
+
+nMappedFile::nMappedFile(const string& path, nMappedAccess access)
+{
+	m_fd = open(path.c_str(), O_RDONLY);
+	if (m_fd < 0)
+		throw "Unable to open the file to map.";
+
+	struct stat status;
+	if (fstat(m_fd, &status) != 0) {
+		close(m_fd);
+		throw "Unable to read the size of the file to map.";
+	}
+	m_size = (size_t)status.st_size;
+
+	// An empty file cannot be mapped, it is represented by a null view.
+	if (m_size) {
+		void* pData = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+		if (pData == MAP_FAILED) {
+			close(m_fd);
+			throw "Unable to map the file.";
+		}
+		m_pData = (const unsigned char*)pData;
+	}
+
+	Advise(access);
+}
+
+nMappedFile::~nMappedFile()
+{
+	if (m_pData)
+		munmap((void*)m_pData, m_size);
+	if (m_fd >= 0)
+		close(m_fd);
+}
+
+void nMappedFile::Advise(nMappedAccess access) const
+{
+	if (!m_pData)
+		return;
+
+	int advice = MADV_NORMAL;
+	switch (access)
+	{
+	case nMappedAccess::Sequential: advice = MADV_SEQUENTIAL; break;
+	case nMappedAccess::Random:     advice = MADV_RANDOM;     break;
+	case nMappedAccess::WillNeed:   advice = MADV_WILLNEED;   break;
+	default:                        break;
+	}
+
+	madvise((void*)m_pData, m_size, advice);
+}
+
+#endif
+
+/*-------------------------------------------------------------------------------------------------
+	Sensable files
+-------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+	size_t GetElementSize(nElementType elementType)
+	{
+		switch (elementType)
+		{
+		case nElementType::U8:  return 1;
+		case nElementType::U16: return 2;
+		case nElementType::I32: return 4;
+		case nElementType::F32: return 4;
+		case nElementType::F64: return 8;
+		default:                throw "Unknown sensable element type.";
+		}
+	}
+}
+
+nSensableFileHeader ReadSensableFileHeader(const nMappedFile& file, nElementType elementType)
+{
+	nSensableFileHeader header;
+
+	if (file.GetSize() < sizeof(header))
+		throw "The file is too short to be a sensable file.";
+
+	memcpy(&header, file.GetData(), sizeof(header));
+
+	if (memcmp(header.Magic, "nSNS", 4) != 0)
+		throw "The file is not a sensable file.";
+
+	if (header.Version != SENSABLE_FILE_VERSION)
+		throw "Unsupported sensable file version.";
+
+	if (header.ElementType != (uint8_t)elementType)
+		throw "The sensable file does not hold the requested element type.";
+
+	if (header.DimensionCount < 1 || header.DimensionCount > 3)
+		throw "A sensable file must have 1 to 3 dimensions.";
+
+	size_t elementSize = GetElementSize(elementType);
+	if (header.DataOffset < sizeof(header) || header.DataOffset % elementSize)
+		throw "The sensable file has an invalid data offset.";
+
+	size_t elementCount = 1;
+	for (int x = 0; x < header.DimensionCount; ++x) {
+		if (header.Lengths[x] == 0 || header.Lengths[x] > INT_MAX)
+			throw "The sensable file has an invalid dimension length.";
+		if (elementCount > SIZE_MAX / header.Lengths[x])
+			throw "The sensable file has more elements than can be addressed.";
+		elementCount *= header.Lengths[x];
+	}
+
+	if (header.DataOffset > file.GetSize() || (file.GetSize() - header.DataOffset) / elementSize < elementCount)
+		throw "The sensable file is truncated.";
+
+	return header;
+}
+
+void WriteSensableFile(const string& path, nElementType elementType, const vector<int>& lengths, const void* pData)
+{
+	if (lengths.empty() || lengths.size() > 3)
+		throw "A sensable file must have 1 to 3 dimensions.";
+
+	nSensableFileHeader header{};
+	memcpy(header.Magic, "nSNS", 4);
+	header.Version        = SENSABLE_FILE_VERSION;
+	header.ElementType    = (uint8_t)elementType;
+	header.DimensionCount = (uint8_t)lengths.size();
+	header.DataOffset     = sizeof(header);
+
+	size_t elementCount = 1;
+	for (int x = 0; x < 3; ++x) {
+		header.Lengths[x] = x < (int)lengths.size() ? (uint32_t)lengths[x] : 1;
+		elementCount *= header.Lengths[x];
+	}
+
+	ofstream out(path, ios::binary | ios::trunc);
+	if (!out)
+		throw "Unable to create the sensable file.";
+
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)pData, elementCount * GetElementSize(elementType));
+
+	if (!out)
+		throw "Unable to write the sensable file.";
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include <type_traits>
+#include "../nNetwork/nNetwork.h"
+#include "IntegeralSensing.h"
+
+//++ nMappedAccess
+//
+//+ Purpose:
+//		Access pattern hint for a mapped file, forwarded to madvise (or PrefetchVirtualMemory on
+//		Windows for WillNeed).
+enum class nMappedAccess {
+	Normal,
+	Sequential,
+	Random,
+	WillNeed
+};
+
+//++ nMappedFile
+//
+//+ Purpose:
+//		Read-only memory mapping of a whole file.
+//
+//+ Remarks:
+//		The mapping is created in the constructor and released in the destructor. Pages are only
+//		read from disk when they are touched, so opening a file costs the same no matter how
+//		large it is.
+class nMappedFile {
+public:
+	nMappedFile(const std::string& path, nMappedAccess access = nMappedAccess::Normal);
+	~nMappedFile();
+
+	nMappedFile(const nMappedFile&) = delete;
+	nMappedFile& operator=(const nMappedFile&) = delete;
+
+	const unsigned char* GetData() const { return m_pData; }
+	size_t               GetSize() const { return m_size; }
+
+	void Advise(nMappedAccess access) const;
+
+private:
+	const unsigned char* m_pData{ nullptr };
+	size_t               m_size{ 0 };
+
+#ifdef _WIN32
+	void* m_hFile{ nullptr };
+	void* m_hMapping{ nullptr };
+#else
+	int   m_fd{ -1 };
+#endif
+};
+
+//++ nElementType
+//
+//+ Purpose:
+//		Element types that can be stored in a sensable file.
+enum class nElementType : uint8_t {
+	U8    = 1,
+	U16   = 2,
+	I32   = 3,
+	F32   = 4,
+	F64   = 5
+};
+
+template<typename T> struct nElementTypeOf;
+template<> struct nElementTypeOf<uint8_t>  { static const nElementType Value = nElementType::U8;  };
+template<> struct nElementTypeOf<uint16_t> { static const nElementType Value = nElementType::U16; };
+template<> struct nElementTypeOf<int32_t>  { static const nElementType Value = nElementType::I32; };
+template<> struct nElementTypeOf<float>    { static const nElementType Value = nElementType::F32; };
+template<> struct nElementTypeOf<double>   { static const nElementType Value = nElementType::F64; };
+
+//++ nSensableFileHeader
+//
+//+ Purpose:
+//		Header of a sensable file. All fields are little-endian.
+//
+//+ Remarks:
+//		The elements follow at DataOffset, row major with dimension 1 varying fastest. Unused
+//		dimensions have a length of 1.
+struct nSensableFileHeader {
+	char     Magic[4];        // "nSNS"
+	uint16_t Version;         // SENSABLE_FILE_VERSION
+	uint8_t  ElementType;     // nElementType
+	uint8_t  DimensionCount;  // 1 to 3
+	uint32_t Lengths[3];
+	uint32_t DataOffset;      // From the start of the file, a multiple of the element size.
+	uint8_t  Reserved[8];
+};
+
+static_assert(sizeof(nSensableFileHeader) == 32, "nSensableFileHeader must be 32 bytes.");
+
+const uint16_t SENSABLE_FILE_VERSION = 1;
+
+// Validates the header at the start of file and returns it. Throws if the file is not a
+// sensable file of the given element type, or is too short for the data that it describes.
+nSensableFileHeader ReadSensableFileHeader(const nMappedFile& file, nElementType elementType);
+
+// Write a sensable file with a header, for use with MappedSensable<T>::Open.
+void WriteSensableFile(const std::string& path, nElementType elementType, const std::vector<int>& lengths, const void* pData);
+
+template<typename T>
+void WriteSensableFile(const std::string& path, const std::vector<int>& lengths, const T* pData) {
+	WriteSensableFile(path, nElementTypeOf<T>::Value, lengths, pData);
+}
+
+//++ MappedSensable
+//
+//+ Purpose:
+//		ISensable over a memory mapped file of raw little-endian elements.
+//
+//+ Remarks:
+//		T is one of uint8_t, uint16_t, int32_t or float. The sensable reads the mapped pages in
+//		place, nothing is copied. Integral sensables are IIntegralSensables, so they can be used
+//		with IntegralSensor, MappedSensor works for every element type.
+template<typename T>
+class MappedSensable : public std::conditional<std::is_integral<T>::value, IIntegralSensable<T>, nNetwork::ISensable<T>>::type {
+public:
+	// Map a raw dump with a caller provided shape. The elements start at dataOffset.
+	MappedSensable(const std::string& path, const std::vector<int>& lengths, size_t dataOffset = 0, nMappedAccess access = nMappedAccess::Normal)
+		: m_pFile{ std::make_shared<nMappedFile>(path, access) }
+	{
+		Bind(lengths, dataOffset);
+	}
+
+	// Map a file written by WriteSensableFile, the shape comes from its header.
+	static std::unique_ptr<MappedSensable<T>> Open(const std::string& path, nMappedAccess access = nMappedAccess::Normal) {
+		auto pFile  = std::make_shared<nMappedFile>(path, access);
+		auto header = ReadSensableFileHeader(*pFile, nElementTypeOf<T>::Value);
+
+		std::vector<int> lengths;
+		for (int x = 0; x < header.DimensionCount; ++x)
+			lengths.push_back((int)header.Lengths[x]);
+
+		return std::unique_ptr<MappedSensable<T>>(new MappedSensable<T>(pFile, lengths, header.DataOffset));
+	}
+
+	virtual ~MappedSensable() {}
+
+	virtual int GetDimensionCount() const override { return (int)m_lengths.size(); }
+	virtual int GetDimensionLength(int dimension) const override {
+		assert(dimension >= 1 && dimension <= (int)m_lengths.size());
+		return m_lengths[dimension - 1];
+	}
+
+	virtual T Sense(const std::vector<int>& location) const override {
+		return m_pData[this->GetLinearOffset(location)];
+	}
+
+	virtual void SenseBatch(const int* pOffsets, int count, T* pResults) const override {
+		for (int x = 0; x < count; ++x)
+			pResults[x] = m_pData[pOffsets[x]];
+	}
+
+	// Zero copy access to the mapped elements.
+	const T* GetData()         const { return m_pData; }
+	size_t   GetElementCount() const { return m_elementCount; }
+
+	void Advise(nMappedAccess access) const { m_pFile->Advise(access); }
+
+private:
+	MappedSensable(std::shared_ptr<nMappedFile> pFile, const std::vector<int>& lengths, size_t dataOffset)
+		: m_pFile{ pFile }
+	{
+		Bind(lengths, dataOffset);
+	}
+
+	void Bind(const std::vector<int>& lengths, size_t dataOffset) {
+		// The file is read in place, which is only correct on a little-endian host.
+		const uint16_t probe = 1;
+		if (*(const uint8_t*)&probe != 1)
+			throw "Mapped sensables require a little-endian host.";
+
+		if (lengths.empty() || lengths.size() > 3)
+			throw "A mapped sensable must have 1 to 3 dimensions.";
+
+		if (dataOffset % sizeof(T))
+			throw "The data offset of a mapped sensable must be a multiple of the element size.";
+
+		m_elementCount = 1;
+		for (auto length : lengths) {
+			if (length <= 0)
+				throw "Every dimension of a mapped sensable must have a positive length.";
+			if (m_elementCount > SIZE_MAX / (size_t)length)
+				throw "A mapped sensable has more elements than can be addressed.";
+			m_elementCount *= (size_t)length;
+		}
+
+		if (dataOffset > m_pFile->GetSize() || (m_pFile->GetSize() - dataOffset) / sizeof(T) < m_elementCount)
+			throw "The mapped file is too short for the requested shape.";
+
+		m_lengths = lengths;
+		m_pData   = reinterpret_cast<const T*>(m_pFile->GetData() + dataOffset);
+	}
+
+	std::shared_ptr<nMappedFile> m_pFile;
+	std::vector<int>             m_lengths;
+	const T*                     m_pData{ nullptr };
+	size_t                       m_elementCount{ 0 };
+};
+
+//++ MappedSensor
+//
+//+ Purpose:
+//		Normalises the values of a MappedSensable by dividing them by max. Works for every
+//		element type, including float, and gathers straight from the mapped data.
+template<typename T>
+class MappedSensor : public nNetwork::ISensor {
+public:
+	MappedSensor(const MappedSensable<T>* pSensable, T max) : m_pSensable{ pSensable }, m_max{ max } {};
+	virtual ~MappedSensor() {}
+
+	virtual vType Sense(const std::vector<int>& location) const override { return (vType)m_pSensable->Sense(location) / (vType)m_max; }
+
+	virtual int GetLinearOffset(const std::vector<int>& location) const override { return m_pSensable->GetLinearOffset(location); }
+
+	virtual void SenseBatch(const int* pOffsets, int count, vType* pResults) const override {
+		const T* pData = m_pSensable->GetData();
+		for (int x = 0; x < count; ++x)
+			pResults[x] = (vType)pData[pOffsets[x]] / (vType)m_max;
+	}
+
+protected:
+	const MappedSensable<T>* m_pSensable;
+	T m_max;
+};
@@ -0,0 +1,164 @@
+#include "NetworkFile.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace nNetwork;
+
+namespace {
+
+	// Byte offsets of the sections that follow the header, see nNetworkFileHeader.
+	struct nNetworkFileLayout {
+		size_t LayerCounts;
+		size_t CurrentValues;
+		size_t Decays;
+		size_t RestCounts;
+		size_t MaxRestCounts;
+		size_t RowOffsets;
+		size_t Targets;
+		size_t Weights;
+		size_t Spikes;
+		size_t Size;
+	};
+
+	size_t Align8(size_t offset) { return (offset + 7) & ~(size_t)7; }
+
+	nNetworkFileLayout GetLayout(const nNetworkFileHeader& header)
+	{
+		size_t nodeCount    = header.NodeCount;
+		size_t synapseCount = header.SynapseCount;
+
+		nNetworkFileLayout layout;
+		layout.LayerCounts   = sizeof(nNetworkFileHeader);
+		layout.CurrentValues = Align8(layout.LayerCounts   + header.LayerCount * sizeof(int32_t));
+		layout.Decays        = Align8(layout.CurrentValues + nodeCount * sizeof(vType));
+		layout.RestCounts    = Align8(layout.Decays        + nodeCount * sizeof(vType));
+		layout.MaxRestCounts = Align8(layout.RestCounts    + nodeCount * sizeof(int32_t));
+		layout.RowOffsets    = Align8(layout.MaxRestCounts + nodeCount * sizeof(int32_t));
+		layout.Targets       = Align8(layout.RowOffsets    + (nodeCount + 1) * sizeof(int32_t));
+		layout.Weights       = Align8(layout.Targets       + synapseCount * sizeof(int32_t));
+		layout.Spikes        = Align8(layout.Weights       + synapseCount * sizeof(vType));
+		layout.Size          = layout.Spikes + (header.Flags & NETWORK_FILE_SPIKES ? nodeCount : 0);
+		return layout;
+	}
+
+	void CheckHostByteOrder()
+	{
+		const uint16_t probe = 1;
+		if (*(const uint8_t*)&probe != 1)
+			throw "Network files can only be used on little-endian hosts.";
+	}
+
+	void WriteSection(ofstream& out, const void* pData, size_t size)
+		// Pad to the section's offset, then write it.
+	{
+		static const char padding[8] = {};
+
+		size_t position = (size_t)out.tellp();
+		out.write(padding, Align8(position) - position);
+		out.write((const char*)pData, size);
+	}
+
+	template<typename T>
+	nSpan<const T> GetSection(const nMappedFile& file, size_t offset, size_t count)
+	{
+		return { (const T*)(file.GetData() + offset), (int)count };
+	}
+}
+
+void WriteNetworkFile(const string& path, const nNodeNetwork& network)
+{
+	vector<int> layerCounts;
+	WriteNetworkFile(path, network.GetImage(layerCounts), 0);
+}
+
+void WriteNetworkFile(const string& path, const nNetworkImage& image, int iteration)
+{
+	CheckHostByteOrder();
+
+	nNetworkFileHeader header{};
+	memcpy(header.Magic, "nNET", 4);
+	header.Version      = NETWORK_FILE_VERSION;
+	header.ValueType    = (uint8_t)nElementTypeOf<vType>::Value;
+	header.LayerCount   = (uint32_t)image.LayerCounts.size();
+	header.NodeCount    = (uint32_t)image.CurrentValues.size();
+	header.SynapseCount = (uint32_t)image.Targets.size();
+	header.Flags        = image.Spikes.empty() ? 0 : NETWORK_FILE_SPIKES;
+	header.Iteration    = (uint32_t)iteration;
+
+	ofstream out(path, ios::binary | ios::trunc);
+	if (!out)
+		throw "Unable to create the network file.";
+
+	out.write((const char*)&header, sizeof(header));
+	WriteSection(out, image.LayerCounts.data(),   image.LayerCounts.size()   * sizeof(int32_t));
+	WriteSection(out, image.CurrentValues.data(), image.CurrentValues.size() * sizeof(vType));
+	WriteSection(out, image.Decays.data(),        image.Decays.size()        * sizeof(vType));
+	WriteSection(out, image.RestCounts.data(),    image.RestCounts.size()    * sizeof(int32_t));
+	WriteSection(out, image.MaxRestCounts.data(), image.MaxRestCounts.size() * sizeof(int32_t));
+	WriteSection(out, image.RowOffsets.data(),    image.RowOffsets.size()    * sizeof(int32_t));
+	WriteSection(out, image.Targets.data(),       image.Targets.size()       * sizeof(int32_t));
+	WriteSection(out, image.Weights.data(),       image.Weights.size()       * sizeof(vType));
+	if (!image.Spikes.empty())
+		WriteSection(out, image.Spikes.data(), image.Spikes.size());
+
+	if (!out)
+		throw "Unable to write the network file.";
+}
+
+nNetworkFileHeader ReadNetworkFileHeader(const nMappedFile& file)
+{
+	CheckHostByteOrder();
+
+	nNetworkFileHeader header;
+
+	if (file.GetSize() < sizeof(header))
+		throw "The file is too short to be a network file.";
+
+	memcpy(&header, file.GetData(), sizeof(header));
+
+	if (memcmp(header.Magic, "nNET", 4) != 0)
+		throw "The file is not a network file.";
+
+	if (header.Version != NETWORK_FILE_VERSION)
+		throw "Unsupported network file version.";
+
+	if (header.ValueType != (uint8_t)nElementTypeOf<vType>::Value)
+		throw "The network file does not hold the value type of this build.";
+
+	if (header.NodeCount > (uint32_t)INT32_MAX - 1 || header.SynapseCount > (uint32_t)INT32_MAX || header.LayerCount > header.NodeCount)
+		throw "The network file is too large.";
+
+	if (file.GetSize() < GetLayout(header).Size)
+		throw "The network file is truncated.";
+
+	return header;
+}
+
+unique_ptr<nNodeNetwork> ReadNetworkFile(const string& path, const ISensor& sensor, const nNodeNetworkConfig& config, int* pIteration)
+	// The sections are used in place from the mapping, the network copies each of them once.
+	// nNodeNetwork validates the contents, so only the header and the file size are checked here.
+{
+	nMappedFile file{ path, nMappedAccess::Sequential };
+
+	nNetworkFileHeader header = ReadNetworkFileHeader(file);
+	nNetworkFileLayout layout = GetLayout(header);
+
+	nNetworkImage image;
+	image.LayerCounts   = GetSection<int>(file, layout.LayerCounts, header.LayerCount);
+	image.CurrentValues = GetSection<vType>(file, layout.CurrentValues, header.NodeCount);
+	image.Decays        = GetSection<vType>(file, layout.Decays, header.NodeCount);
+	image.RestCounts    = GetSection<int>(file, layout.RestCounts, header.NodeCount);
+	image.MaxRestCounts = GetSection<int>(file, layout.MaxRestCounts, header.NodeCount);
+	image.RowOffsets    = GetSection<int>(file, layout.RowOffsets, header.NodeCount + 1);
+	image.Targets       = GetSection<int>(file, layout.Targets, header.SynapseCount);
+	image.Weights       = GetSection<vType>(file, layout.Weights, header.SynapseCount);
+	if (header.Flags & NETWORK_FILE_SPIKES)
+		image.Spikes    = GetSection<uint8_t>(file, layout.Spikes, header.NodeCount);
+
+	if (pIteration)
+		*pIteration = (int)header.Iteration;
+
+	return make_unique<nNodeNetwork>(image, sensor, config);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include "../nNetwork/nNetwork.h"
+#include "MappedSensing.h"
+
+//++ nNetworkFileHeader
+//
+//+ Purpose:
+//		Header of a network file. All fields are little-endian.
+//
+//+ Remarks:
+//		The header is followed by these sections, in order, each starting on an 8 byte
+//		boundary:
+//			LayerCounts     int32[LayerCount]
+//			CurrentValues   value[NodeCount]
+//			Decays          value[NodeCount]
+//			RestCounts      int32[NodeCount]
+//			MaxRestCounts   int32[NodeCount]
+//			RowOffsets      int32[NodeCount + 1]
+//			Targets         int32[SynapseCount]
+//			Weights         value[SynapseCount]
+//			Spikes          uint8[NodeCount], only when Flags has NETWORK_FILE_SPIKES
+//		value is the element type in ValueType, which must match vType.
+struct nNetworkFileHeader {
+	char     Magic[4];        // "nNET"
+	uint16_t Version;         // NETWORK_FILE_VERSION
+	uint8_t  ValueType;       // nElementType
+	uint8_t  Reserved0;
+	uint32_t LayerCount;
+	uint32_t NodeCount;
+	uint32_t SynapseCount;
+	uint32_t Flags;
+	uint32_t Iteration;       // nExecuter iteration count when the file was written, or 0.
+	uint8_t  Reserved[36];
+};
+
+static_assert(sizeof(nNetworkFileHeader) == 64, "nNetworkFileHeader must be 64 bytes.");
+
+const uint16_t NETWORK_FILE_VERSION = 1;
+
+// Flags
+const uint32_t NETWORK_FILE_SPIKES = 1;		// Pending nPropagationMode::Synchronous spikes are saved.
+
+// Validates the header at the start of file and returns it. Throws if the file is not a network
+// file for this build's vType, or is too short for the sections that it describes.
+nNetworkFileHeader ReadNetworkFileHeader(const nMappedFile& file);
+
+// Save the complete network, its layout, node parameters, tick state and weights.
+void WriteNetworkFile(const std::string& path, const nNetwork::nNodeNetwork& network);
+void WriteNetworkFile(const std::string& path, const nNetwork::nNetworkImage& image, int iteration);
+
+// Map a network file, validate it and build the network from it. The sensor and the sense
+// locations in config are not part of the file. The saved iteration count is stored in
+// pIteration when it is not null.
+std::unique_ptr<nNetwork::nNodeNetwork> ReadNetworkFile(const std::string& path, const nNetwork::ISensor& sensor, const nNetwork::nNodeNetworkConfig& config, int* pIteration = nullptr);
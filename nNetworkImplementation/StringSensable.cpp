@@ -33,5 +33,12 @@ unsigned char StringSensable::Sense(const std::vector<int>& location) const {
 		throw new exception("location is out of range.");
 #endif
 
-	return _target.substr(location[0], 1)[0];
+	return (unsigned char)_target[location[0]];
+}
+
+void StringSensable::SenseBatch(const int* pOffsets, int count, unsigned char* pResults) const {
+	const char* pTarget = _target.data();
+
+	for (int x = 0; x < count; ++x)
+		pResults[x] = (unsigned char)pTarget[pOffsets[x]];
 }
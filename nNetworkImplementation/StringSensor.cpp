@@ -23,3 +23,20 @@ vType StringSensor::Sense(const std::vector<int>& location) const {
 
 	return (vType)sensedChar / 255.0f;
 }
+
+void StringSensor::SenseBatch(const int* pOffsets, int count, vType* pResults) const {
+
+	// Sense in chunks through a stack buffer, one virtual call per chunk rather than one
+	// per location.
+	const int chunkSize = 256;
+	unsigned char sensed[chunkSize];
+
+	for (int begin = 0; begin < count; begin += chunkSize) {
+		int chunk = count - begin < chunkSize ? count - begin : chunkSize;
+
+		_pSensable->SenseBatch(pOffsets + begin, chunk, sensed);
+
+		for (int x = 0; x < chunk; ++x)
+			pResults[begin + x] = (vType)sensed[x] / 255.0f;
+	}
+}
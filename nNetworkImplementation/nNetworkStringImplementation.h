@@ -11,6 +11,10 @@ public:
 	virtual int GetDimensionLength(int dimension) const override;
 
 	virtual unsigned char Sense(const std::vector<int>& location) const override;	
+	virtual int  GetLinearOffset(const std::vector<int>& location) const override { return location[0]; }
+	virtual void SenseBatch(const int* pOffsets, int count, unsigned char* pResults) const override;
+
+	unsigned char Sense(int location) const { return (unsigned char)_target[location]; }
 
 protected:
 	std::string _target;
@@ -23,8 +27,10 @@ public:
 	virtual ~StringSensor();
 
 	virtual vType Sense(const std::vector<int>& location) const override;
+	virtual int   GetLinearOffset(const std::vector<int>& location) const override { return _pSensable->GetLinearOffset(location); }
+	virtual void  SenseBatch(const int* pOffsets, int count, vType* pResults) const override;
 
-	vType Sense(int location) const { return Sense(std::vector<int>{location}); }
+	vType Sense(int location) const { return (vType)_pSensable->Sense(location) / 255.0f; }
 
 protected:
 	StringSensable *_pSensable;
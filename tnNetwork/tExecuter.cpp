@@ -2,6 +2,8 @@
 #include <vector>
 #include "CppUnitTest.h"
 #include <memory>
+#include <thread>
+#include <chrono>
 
 #include "../nNetworkImplementation/nNetworkStringImplementation.h"
 
@@ -37,6 +39,76 @@ namespace tnNetwork
 
 			pExecuter->Exit();		
 		}
+
+		TEST_METHOD(tExecuter_PauseStopsTicking)
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pExecuter       = make_unique<nNetwork::nExecuter>(vector<int>{5, 3, 2, 1}, *(pStringSensor.get()));
+
+			pExecuter->Start();
+			while (pExecuter->GetCurrentIterations() < 100) {}
+
+			// The tick in progress when Pause is called may still complete.
+			pExecuter->Pause();
+			this_thread::sleep_for(chrono::milliseconds(50));
+
+			int pausedIterations = pExecuter->GetCurrentIterations();
+			this_thread::sleep_for(chrono::milliseconds(50));
+			Assert::AreEqual(pausedIterations, pExecuter->GetCurrentIterations());
+
+			// A parked executer must wake up again.
+			pExecuter->Start();
+			while (pExecuter->GetCurrentIterations() < pausedIterations + 100) {}
+
+			pExecuter->Exit();
+		}
+
+		TEST_METHOD(tExecuter_SnapShotWhileRunning)
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pExecuter       = make_unique<nNetwork::nExecuter>(vector<int>{5, 3, 2, 1}, *(pStringSensor.get()));
+
+			pExecuter->Start();
+
+			for (int x = 0; x < 20; ++x) {
+				auto pSnapShot = pExecuter->GetSnapShot();
+				Assert::AreEqual(23, pSnapShot->GetSynapseCount());
+			}
+
+			pExecuter->Exit();
+		}
+
+		TEST_METHOD(tExecuter_SnapShotWhilePaused)
+			// A paused executer publishes its exact state, so two snapshots taken while it is
+			// paused must match.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pExecuter       = make_unique<nNetwork::nExecuter>(vector<int>{5, 3, 2, 1}, *(pStringSensor.get()));
+
+			pExecuter->Start();
+			while (pExecuter->GetCurrentIterations() < 1000) {}
+			pExecuter->Pause();
+			this_thread::sleep_for(chrono::milliseconds(50));
+
+			auto pFirst  = pExecuter->GetSnapShot();
+			auto pSecond = pExecuter->GetSnapShot();
+
+			nNetwork::nNetworkState state;
+			pExecuter->GetState(state);
+			Assert::AreEqual(pExecuter->GetCurrentIterations(), state.Iteration);
+
+			pFirst->ForEach([&pSecond, &state](const nNetwork::nNode& node) {
+				auto other = pSecond->GetNodeByNetworkId(node.GetNetworkId());
+				Assert::AreEqual(node.GetCurrentValue(), other.GetCurrentValue());
+				Assert::AreEqual(node.GetRestCount(), other.GetRestCount());
+				Assert::AreEqual(node.GetCurrentValue(), state.CurrentValues[node.GetNetworkId()]);
+			});
+
+			pExecuter->Exit();
+		}
 	};
 
 }
\ No newline at end of file
@@ -42,5 +42,27 @@ namespace tnNetwork {
 			Assert::AreNotEqual(0.0, (double)result);
 		}
 
+		TEST_METHOD(tStringSensor_SenseBatch)
+			// SenseBatch must return exactly what Sense returns for each location. Use more
+			// locations than the sensor's internal chunk size.
+		{
+			string testString{ "Test String" };
+			unique_ptr<StringSensable> pTestSensable = make_unique<StringSensable>(testString);
+			unique_ptr<StringSensor>   pTestSensor   = make_unique<StringSensor>(pTestSensable.get());
+
+			vector<vector<int>> locations;
+			vector<int>         offsets;
+			for (int x = 0; x < 1000; ++x) {
+				locations.push_back(vector<int>{ x % (int)testString.length() });
+				offsets.push_back(pTestSensor->GetLinearOffset(locations.back()));
+			}
+
+			vector<vType> results(locations.size());
+			pTestSensor->SenseBatch(offsets.data(), (int)offsets.size(), results.data());
+
+			for (unsigned x = 0; x < locations.size(); ++x)
+				Assert::AreEqual(pTestSensor->Sense(locations[x]), results[x]);
+		}
+
 	};
 }
\ No newline at end of file
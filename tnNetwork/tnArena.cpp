@@ -0,0 +1,132 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetwork/nArena.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tArena)
+	{
+	public:
+		static nNodeNetworkConfig GetConfig()
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{ nodeLocation % 11 }; }
+			};
+			Config.Seed = 99;
+			return Config;
+		}
+
+		TEST_METHOD(tArena_Allocate)
+			// Allocations are aligned and come from the current block until it is full.
+		{
+			nArena arena{ 1024 };
+			Assert::AreEqual(0, arena.GetBlockCount());
+
+			char*   pChar   = static_cast<char*>(arena.Allocate(3, 1));
+			double* pDouble = static_cast<double*>(arena.Allocate(10 * sizeof(double), alignof(double)));
+
+			Assert::AreEqual((uintptr_t)0, (uintptr_t)pDouble % alignof(double));
+			Assert::IsTrue((char*)pDouble > pChar && (char*)pDouble < pChar + 16);
+			Assert::AreEqual(1, arena.GetBlockCount());
+			Assert::AreEqual((size_t)(3 + 10 * sizeof(double)), arena.GetUsedSize());
+
+			arena.Allocate(1000, 1);
+			Assert::AreEqual(2, arena.GetBlockCount());
+
+			arena.Reserve(5000);
+			Assert::AreEqual(3, arena.GetBlockCount());
+			arena.Allocate(5000, 1);
+			Assert::AreEqual(3, arena.GetBlockCount());
+
+			arena.Release();
+			Assert::AreEqual(0, arena.GetBlockCount());
+			Assert::AreEqual((size_t)0, arena.GetCapacity());
+		}
+
+		TEST_METHOD(tArena_NetworkIsOneBlock)
+			// A network sizes its own arena from its layer counts, so its arrays take one block.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			nNodeNetworkConfig Config = GetConfig();
+			auto pFull = make_unique<nNodeNetwork>(vector<int>{ 2000, 300, 20, 1 }, *pSensor, Config);
+
+			Config.Connectivity = nConnectivityProfile{ nConnectivity::FixedFanOut, /*FanOut*/ 7 };
+			auto pSparse = make_unique<nNodeNetwork>(vector<int>{ 2000, 300, 20, 1 }, *pSensor, Config);
+
+			Assert::AreEqual(1, pFull->GetArena().GetBlockCount());
+			Assert::AreEqual(1, pSparse->GetArena().GetBlockCount());
+			Assert::IsTrue(pSparse->GetArena().GetCapacity() < pFull->GetArena().GetCapacity());
+
+			auto pSnapShot = pFull->GetSnapShot();
+			Assert::AreEqual(1, pSnapShot->GetArena().GetBlockCount());
+			Assert::AreNotEqual(&pFull->GetArena(), &pSnapShot->GetArena());
+		}
+
+		TEST_METHOD(tArena_CallerArena)
+			// Networks built in a caller supplied arena tick as the same networks built in arenas
+			// of their own. Their snapshots take nothing from the shared arena.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			nArena arena;
+
+			nNodeNetworkConfig Config = GetConfig();
+			auto pOwn = make_unique<nNodeNetwork>(vector<int>{ 11, 5, 3, 1 }, *pSensor, Config);
+
+			Config.pArena = &arena;
+			auto pShared  = make_unique<nNodeNetwork>(vector<int>{ 11, 5, 3, 1 }, *pSensor, Config);
+			auto pOther   = make_unique<nNodeNetwork>(vector<int>{ 40, 1 }, *pSensor, Config);
+
+			Assert::AreEqual(&arena, const_cast<nArena*>(&pShared->GetArena()));
+			Assert::AreEqual(&arena, const_cast<nArena*>(&pOther->GetArena()));
+
+			for (int tick = 0; tick < 100; ++tick) {
+				pOwn->Tick();
+				pShared->Tick();
+			}
+
+			size_t used = arena.GetUsedSize();
+
+			for (int x = 0; x < 10; ++x)
+				pShared->GetSnapShot();
+
+			auto pSnapShot = pShared->GetSnapShot();
+			Assert::AreNotEqual(&arena, const_cast<nArena*>(&pSnapShot->GetArena()));
+			Assert::IsNull(pSnapShot->GetConfig().pArena);
+			Assert::AreEqual(used, arena.GetUsedSize());
+
+			for (int tick = 0; tick < 100; ++tick) {
+				pOwn->Tick();
+				pSnapShot->Tick();
+			}
+
+			for (int x = 0; x < pOwn->GetNodeCount(); ++x) {
+				Assert::AreEqual(pOwn->GetCurrentValues()[x], pSnapShot->GetCurrentValues()[x]);
+				Assert::AreEqual(pOwn->GetRestCounts()[x], pSnapShot->GetRestCounts()[x]);
+			}
+
+			pOther.reset();
+			Assert::AreEqual(used, arena.GetUsedSize());
+		}
+	};
+}
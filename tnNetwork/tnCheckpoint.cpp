@@ -0,0 +1,104 @@
+#include "CppUnitTest.h"
+#include "../nNetworkImplementation/Checkpoint.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <fstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tCheckpoint)
+	{
+	public:
+		TEST_METHOD(t_Checkpoint_Resume)
+			// Checkpoint a paused executer, resume a new executer from the checkpoint and make sure
+			// it has the same state and iteration count.
+		{
+			nCheckpointConfig config;
+			config.Name      = "t_Checkpoint_Resume";
+			config.Retention = 2;
+
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pExecuter       = make_unique<nExecuter>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			pExecuter->Start();
+			while (pExecuter->GetCurrentIterations() < 1000) {}
+			pExecuter->Pause();
+			this_thread::sleep_for(chrono::milliseconds(50));
+
+			{
+				nCheckpointer checkpointer{ *pExecuter, config };
+				checkpointer.Checkpoint();
+
+				// Nothing ran, so there is nothing new to write.
+				checkpointer.Checkpoint();
+				Assert::AreEqual(1, checkpointer.GetCheckpointCount());
+			}
+
+			auto pResumed = ResumeExecuter(config, *pStringSensor, pExecuter->GetSnapShot()->GetConfig());
+			Assert::AreEqual(pExecuter->GetCurrentIterations(), pResumed->GetCurrentIterations());
+
+			auto pSnapShot        = pExecuter->GetSnapShot();
+			auto pResumedSnapShot = pResumed->GetSnapShot();
+			pSnapShot->ForEach([&pResumedSnapShot](const nNode& node) {
+				auto resumed = pResumedSnapShot->GetNodeByNetworkId(node.GetNetworkId());
+				Assert::AreEqual(node.GetCurrentValue(), resumed.GetCurrentValue());
+				Assert::AreEqual(node.GetRestCount(), resumed.GetRestCount());
+			});
+
+			// The resumed executer keeps counting.
+			pResumed->Start();
+			while (pResumed->GetCurrentIterations() < pExecuter->GetCurrentIterations() + 100) {}
+
+			remove(("./" + config.Name + ".0.nnet").c_str());
+			remove(("./" + config.Name + ".latest").c_str());
+		}
+
+		TEST_METHOD(t_Checkpoint_Background)
+			// A running executer is checkpointed in the background, and only Retention slots
+			// are ever used.
+		{
+			nCheckpointConfig config;
+			config.Name                 = "t_Checkpoint_Background";
+			config.IntervalMilliseconds = 10;
+			config.Retention            = 2;
+			config.Sync                 = nSyncPolicy::None;
+
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pExecuter       = make_unique<nExecuter>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			pExecuter->Start();
+			{
+				nCheckpointer checkpointer{ *pExecuter, config };
+				while (checkpointer.GetCheckpointCount() < 3)
+					this_thread::sleep_for(chrono::milliseconds(5));
+			}
+			pExecuter->Exit();
+
+			auto Exists = [&config](const string& suffix) {
+				ifstream in("./" + config.Name + suffix);
+				return (bool)in;
+			};
+			Assert::IsTrue(Exists(".0.nnet"));
+			Assert::IsTrue(Exists(".1.nnet"));
+			Assert::IsFalse(Exists(".2.nnet"));
+
+			auto pResumed = ResumeExecuter(config, *pStringSensor, pExecuter->GetSnapShot()->GetConfig());
+			Assert::IsTrue(pResumed->GetCurrentIterations() > 0);
+
+			remove(("./" + config.Name + ".0.nnet").c_str());
+			remove(("./" + config.Name + ".1.nnet").c_str());
+			remove(("./" + config.Name + ".latest").c_str());
+		}
+	};
+}
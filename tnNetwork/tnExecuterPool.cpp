@@ -0,0 +1,135 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetwork/nExecuterPool.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tExecuterPool)
+	{
+	public:
+		TEST_METHOD(tExecuterPool_StartPauseExit)
+			// Many networks on two workers: all of them make progress, a paused one stops and
+			// an exited one cannot be started again.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			nExecuterPool pool{ 2, 16 };
+			Assert::AreEqual(2, pool.GetThreadCount());
+
+			vector<nPooledExecuter*> executers;
+			for (int x = 0; x < 10; ++x)
+				executers.push_back(&pool.Add(make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor)));
+			Assert::AreEqual(10, pool.GetExecuterCount());
+
+			// New executers are paused.
+			this_thread::sleep_for(chrono::milliseconds(20));
+			Assert::AreEqual(0, executers[0]->GetCurrentIterations());
+
+			for (auto pExecuter : executers)
+				pExecuter->Start();
+
+			for (auto pExecuter : executers)
+				while (pExecuter->GetCurrentIterations() < 500) { this_thread::yield(); }
+
+			executers[0]->Pause();
+			executers[1]->Exit();
+			this_thread::sleep_for(chrono::milliseconds(50));
+
+			int paused = executers[0]->GetCurrentIterations();
+			int exited = executers[1]->GetCurrentIterations();
+
+			executers[1]->Start();
+			this_thread::sleep_for(chrono::milliseconds(50));
+
+			Assert::AreEqual(paused, executers[0]->GetCurrentIterations());
+			Assert::AreEqual(exited, executers[1]->GetCurrentIterations());
+
+			// The paused executer published its exact state.
+			nNetworkState state;
+			executers[0]->GetState(state);
+			Assert::AreEqual(paused, state.Iteration);
+
+			executers[0]->Start();
+			while (executers[0]->GetCurrentIterations() < paused + 500) { this_thread::yield(); }
+		}
+
+		TEST_METHOD(tExecuterPool_Weights)
+			// On a single worker, an executer with weight 3 gets three times the ticks of one
+			// with weight 1.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			nExecuterPool pool{ 1, 32 };
+
+			auto& light = pool.Add(make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor), 1);
+			auto& heavy = pool.Add(make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor), 3);
+
+			light.Start();
+			heavy.Start();
+
+			// Measure once both are in the run queue.
+			while (light.GetCurrentIterations() < 320 || heavy.GetCurrentIterations() < 960) { this_thread::yield(); }
+			int lightStart = light.GetCurrentIterations();
+			int heavyStart = heavy.GetCurrentIterations();
+
+			while (light.GetCurrentIterations() < lightStart + 3200) { this_thread::yield(); }
+			int lightTicks = light.GetCurrentIterations() - lightStart;
+			int heavyTicks = heavy.GetCurrentIterations() - heavyStart;
+
+			light.Exit();
+			heavy.Exit();
+
+			double ratio = (double)heavyTicks / lightTicks;
+			Assert::IsTrue(ratio > 2.8 && ratio < 3.2);
+		}
+
+		TEST_METHOD(tExecuterPool_Throughput)
+			// Benchmark: aggregate ticks per second of 200 networks, from 1 worker up to every
+			// hardware thread. Only logs, the numbers depend on the machine.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			int maxThreads = max(1, (int)thread::hardware_concurrency());
+
+			vector<int> threadCounts;
+			for (int threads = 1; threads < maxThreads; threads *= 2)
+				threadCounts.push_back(threads);
+			threadCounts.push_back(maxThreads);
+
+			for (int threads : threadCounts) {
+				nExecuterPool pool{ threads };
+
+				vector<nPooledExecuter*> executers;
+				for (int x = 0; x < 200; ++x)
+					executers.push_back(&pool.Add(make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor)));
+
+				for (auto pExecuter : executers)
+					pExecuter->Start();
+
+				this_thread::sleep_for(chrono::milliseconds(200));
+
+				long long ticks = 0;
+				for (auto pExecuter : executers) {
+					pExecuter->Exit();
+					ticks += pExecuter->GetCurrentIterations();
+				}
+
+				string message = to_string(threads) + " worker(s): " + to_string((long long)(ticks / 0.2)) + " ticks/s";
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+	};
+}
@@ -0,0 +1,52 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nFixed16.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tFixed16)
+	{
+	public:
+		TEST_METHOD(tFixed16_Conversion)
+			// Conversion rounds to the nearest step of 2^-14 and saturates at the ends of the
+			// range.
+		{
+			Assert::AreEqual(2, (int)sizeof(nFixed16));
+
+			Assert::AreEqual(1.0, (double)nFixed16{ 1.0 });
+			Assert::AreEqual(0.25, (double)nFixed16{ 0.25 });
+			Assert::AreEqual(-1.5, (double)nFixed16{ -1.5 });
+
+			Assert::AreEqual((int16_t)16384, nFixed16{ 1.0 }.GetRaw());
+			Assert::AreEqual((int16_t)2, nFixed16{ 1.6 / 16384 }.GetRaw());
+			Assert::AreEqual((int16_t)-2, nFixed16{ -1.6 / 16384 }.GetRaw());
+
+			Assert::AreEqual((int16_t)INT16_MAX, nFixed16{ 5.0 }.GetRaw());
+			Assert::AreEqual((int16_t)INT16_MIN, nFixed16{ -5.0 }.GetRaw());
+		}
+
+		TEST_METHOD(tFixed16_Saturation)
+			// Sums saturate instead of wrapping, so a node value plus a weight never comes out
+			// below the trigger point.
+		{
+			nFixed16 value{ 1.0 };
+
+			value += nFixed16{ 0.75 };
+			Assert::AreEqual(1.75, (double)value);
+
+			value += nFixed16{ 0.75 };
+			Assert::AreEqual((int16_t)INT16_MAX, value.GetRaw());
+			Assert::IsTrue(value > 1.0);
+
+			nFixed16 low{ -1.75 };
+			low -= nFixed16{ 1.0 };
+			Assert::AreEqual((int16_t)INT16_MIN, low.GetRaw());
+
+			Assert::IsTrue(nFixed16{ 0.5 } + nFixed16{ 0.25 } == nFixed16{ 0.75 });
+			Assert::IsTrue(nFixed16{ 0.5 } - nFixed16{ 0.75 } < 0);
+		}
+	};
+}
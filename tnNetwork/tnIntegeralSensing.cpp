@@ -2,10 +2,14 @@
 
 #include "CppUnitTest.h"
 #include "../nNetworkImplementation/IntegeralSensing.h"
+#include "../nNetwork/nStaticNetwork.h"
 #include <memory>
+#include <chrono>
+#include <string>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace std;
+using namespace nNetwork;
 
 namespace tNetwork
 {
@@ -80,5 +84,189 @@ namespace tNetwork
 			Assert::AreEqual(1.0/10.0, pIntegralSensor->Sense(vector<int>{0, 0}));
 			Assert::AreEqual(3.0/10.0, pIntegralSensor->Sense(vector<int>{3, 4}));
 		}
+
+		TEST_METHOD(t_IntegralSensor2d_SenseBatch)
+			// SenseBatch must return exactly what Sense returns for each location.
+		{
+			vector<vector<int>> v = vector<vector<int>>
+			{
+				{ vector<int>{ 1, 2, 3, 4 } },
+				{ vector<int>{ 2, 5, 7, 2 } },
+				{ vector<int>{ 3, 6, 8, 3 } }
+			};
+
+			unique_ptr<IntegralSensable2d<int>> pIntegralSensable = make_unique<IntegralSensable2d<int>>(v);
+			unique_ptr<IntegralSensor<int>>     pIntegralSensor   = make_unique<IntegralSensor<int>>(pIntegralSensable.get(), 10);
+
+			vector<vector<int>> locations;
+			vector<int>         offsets;
+			for (int y = 0; y < 3; ++y) {
+				for (int x = 0; x < 4; ++x) {
+					locations.push_back(vector<int>{ x, y });
+					offsets.push_back(pIntegralSensor->GetLinearOffset(locations.back()));
+				}
+			}
+
+			// Row major, x varies fastest.
+			Assert::AreEqual(1 * 4 + 2, pIntegralSensor->GetLinearOffset(vector<int>{ 2, 1 }));
+
+			vector<vType> results(locations.size());
+			pIntegralSensor->SenseBatch(offsets.data(), (int)offsets.size(), results.data());
+
+			for (unsigned x = 0; x < locations.size(); ++x)
+				Assert::AreEqual(pIntegralSensor->Sense(locations[x]), results[x]);
+		}
+
+		TEST_METHOD(t_IntegralSensable2d_StridedView)
+			// View a 4 x 3 image stored with a row pitch of 6 elements, without copying it.
+			// Locations, linear offsets, batches and tiles must all honour the row stride.
+		{
+			vector<int> frame{
+				1, 2, 3, 4, -1, -1,
+				2, 5, 7, 2, -1, -1,
+				3, 6, 8, 3, -1, -1
+			};
+
+			IntegralSensable2d<int> sensable{ frame.data(), 4, 3, 6 };
+
+			Assert::AreEqual(4, sensable.GetDimensionLength(1));
+			Assert::AreEqual(3, sensable.GetDimensionLength(2));
+			Assert::IsTrue(sensable.GetData() == frame.data());
+
+			Assert::AreEqual(7, sensable.Sense(2, 1));
+			Assert::AreEqual(3, sensable.Sense(vector<int>{ 3, 2 }));
+			Assert::AreEqual(2 * 6 + 3, sensable.GetLinearOffset(vector<int>{ 3, 2 }));
+
+			vector<int> offsets{ sensable.GetLinearOffset(vector<int>{ 0, 0 }), sensable.GetLinearOffset(vector<int>{ 1, 2 }) };
+			vector<int> results(offsets.size());
+			sensable.SenseBatch(offsets.data(), (int)offsets.size(), results.data());
+
+			Assert::AreEqual(1, results[0]);
+			Assert::AreEqual(6, results[1]);
+
+			nTileView<int> tile = sensable.GetTile(1, 1, 2, 2);
+			Assert::AreEqual(5, tile(0, 0));
+			Assert::AreEqual(7, tile(1, 0));
+			Assert::AreEqual(6, tile(0, 1));
+			Assert::AreEqual(8, tile(1, 1));
+
+			nTileView<int> row = sensable.GetRow(2);
+			Assert::AreEqual(4, row.Width);
+			Assert::AreEqual(8, row.GetRow(0)[2]);
+		}
+
+		TEST_METHOD(t_IntegralSensableNd_3d)
+			// A contiguous 2 x 2 x 2 volume, dimension 1 varies fastest.
+		{
+			IntegralSensableNd<int> sensable{ vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, vector<int>{ 2, 2, 2 } };
+
+			Assert::AreEqual(3, sensable.GetDimensionCount());
+			Assert::AreEqual((ptrdiff_t)4, sensable.GetStride(3));
+			Assert::AreEqual(1 + 2 + 4, sensable.Sense(vector<int>{ 1, 1, 1 }));
+			Assert::AreEqual(4, sensable.Sense(vector<int>{ 0, 0, 1 }));
+		}
+
+		using BoundSensor1d = BoundIntegralSensor<int, IntegralSensable1d<int>>;
+
+		static nNodeNetworkConfig GetNetworkConfig()
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{ nodeLocation % 64 }; }
+			};
+			Config.Seed = 808;
+			return Config;
+		}
+
+		static vector<int> GetSenseTarget()
+		{
+			vector<int> target(64);
+			for (int x = 0; x < 64; ++x)
+				target[x] = (x * 37) % 100;
+			return target;
+		}
+
+		TEST_METHOD(t_BoundIntegralSensor_SenseBatch)
+			// A bound sensor returns exactly what the virtual IntegralSensor returns.
+		{
+			IntegralSensable1d<int> sensable{ GetSenseTarget() };
+			IntegralSensor<int>     sensor{ &sensable, 100 };
+			BoundSensor1d           bound{ &sensable, 100 };
+
+			vector<int> offsets;
+			for (int x = 0; x < 600; ++x)
+				offsets.push_back(bound.GetLinearOffset(vector<int>{ (x * 7) % 64 }));
+
+			vector<vType> results(offsets.size());
+			vector<vType> boundResults(offsets.size());
+			sensor.SenseBatch(offsets.data(), (int)offsets.size(), results.data());
+			bound.SenseBatch(offsets.data(), (int)offsets.size(), boundResults.data());
+
+			Assert::IsTrue(results == boundResults);
+			Assert::AreEqual(sensor.Sense(vector<int>{ 5 }), bound.Sense(vector<int>{ 5 }));
+		}
+
+		TEST_METHOD(t_BoundIntegralSensor_Tick)
+			// Ticking with the sensor bound statically gives the same network as ticking through
+			// ISensor, for nNodeNetwork and nStaticNetwork.
+		{
+			IntegralSensable1d<int> sensable{ GetSenseTarget() };
+			BoundSensor1d           sensor{ &sensable, 100 };
+
+			nNodeNetwork virtualNetwork{ vector<int>{ 5, 3, 2, 1 }, sensor, GetNetworkConfig() };
+			nNodeNetwork boundNetwork{ vector<int>{ 5, 3, 2, 1 }, sensor, GetNetworkConfig() };
+
+			nStaticNetwork<5, 3, 2, 1> virtualStatic{ virtualNetwork };
+			nStaticNetwork<5, 3, 2, 1> boundStatic{ virtualNetwork };
+
+			for (int tick = 0; tick < 500; ++tick) {
+				virtualNetwork.Tick();
+				boundNetwork.Tick<BoundSensor1d>();
+				virtualStatic.Tick();
+				boundStatic.Tick<BoundSensor1d>();
+			}
+
+			for (int x = 0; x < virtualNetwork.GetNodeCount(); ++x) {
+				Assert::AreEqual(virtualNetwork.GetCurrentValues()[x], boundNetwork.GetCurrentValues()[x]);
+				Assert::AreEqual(virtualNetwork.GetRestCounts()[x], boundNetwork.GetRestCounts()[x]);
+				Assert::AreEqual(virtualNetwork.GetCurrentValues()[x], boundStatic.GetCurrentValue(x));
+				Assert::AreEqual(virtualStatic.GetCurrentValue(x), boundStatic.GetCurrentValue(x));
+			}
+		}
+
+		TEST_METHOD(t_BoundIntegralSensor_TickCost)
+			// Benchmark: two networks with a 4096 node sensing layer, one ticked through ISensor and
+			// one with the sensor bound statically. Only logs, the numbers depend on the machine.
+		{
+			IntegralSensable1d<int> sensable{ GetSenseTarget() };
+			BoundSensor1d           sensor{ &sensable, 100 };
+
+			nNodeNetwork virtualNetwork{ vector<int>{ 4096, 16, 1 }, sensor, GetNetworkConfig() };
+			nNodeNetwork boundNetwork{ vector<int>{ 4096, 16, 1 }, sensor, GetNetworkConfig() };
+
+			const int ticks = 2000;
+
+			auto start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				virtualNetwork.Tick();
+			chrono::duration<double> erased = chrono::steady_clock::now() - start;
+
+			start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				boundNetwork.Tick<BoundSensor1d>();
+			chrono::duration<double> bound = chrono::steady_clock::now() - start;
+
+			string message = "ISensor: " + to_string(erased.count() * 1e9 / ticks) + " ns, bound: " +
+				to_string(bound.count() * 1e9 / ticks) + " ns per tick";
+			Logger::WriteMessage(message.c_str());
+		}
 	};
 }
\ No newline at end of file
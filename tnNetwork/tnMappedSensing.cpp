@@ -0,0 +1,145 @@
+#include "CppUnitTest.h"
+#include "../nNetworkImplementation/MappedSensing.h"
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tMappedSensing)
+	{
+	public:
+		TEST_METHOD(t_MappedSensable_Open)
+			// Write a 2D u16 sensable file, map it and make sure the shape and the values come
+			// back unchanged.
+		{
+			const string path{ "t_MappedSensable_Open.nsns" };
+
+			vector<uint16_t> data{
+				1, 2, 3, 4,
+				5, 6, 7, 8,
+				9, 10, 11, 12
+			};
+			WriteSensableFile(path, vector<int>{ 4, 3 }, data.data());
+
+			{
+				auto pSensable = MappedSensable<uint16_t>::Open(path, nMappedAccess::Sequential);
+
+				Assert::AreEqual(2, pSensable->GetDimensionCount());
+				Assert::AreEqual(4, pSensable->GetDimensionLength(1));
+				Assert::AreEqual(3, pSensable->GetDimensionLength(2));
+				Assert::AreEqual((size_t)12, pSensable->GetElementCount());
+
+				Assert::AreEqual((uint16_t)1,  pSensable->Sense(vector<int>{ 0, 0 }));
+				Assert::AreEqual((uint16_t)7,  pSensable->Sense(vector<int>{ 2, 1 }));
+				Assert::AreEqual((uint16_t)12, pSensable->Sense(vector<int>{ 3, 2 }));
+
+				// Zero copy view of the mapped elements.
+				for (int x = 0; x < 12; ++x)
+					Assert::AreEqual(data[x], pSensable->GetData()[x]);
+			}
+
+			remove(path.c_str());
+		}
+
+		TEST_METHOD(t_MappedSensable_RawShape)
+			// Map a headerless float dump with a caller provided 3D shape and sense it through a
+			// MappedSensor.
+		{
+			const string path{ "t_MappedSensable_RawShape.raw" };
+
+			vector<float> data(2 * 3 * 4);
+			for (int x = 0; x < (int)data.size(); ++x)
+				data[x] = (float)x;
+
+			{
+				ofstream out(path, ios::binary);
+				out.write((const char*)data.data(), data.size() * sizeof(float));
+			}
+
+			{
+				MappedSensable<float> sensable{ path, vector<int>{ 2, 3, 4 } };
+				MappedSensor<float>   sensor{ &sensable, 100.0f };
+
+				// x + 2 * y + 6 * z
+				Assert::AreEqual(1 + 2 * 2 + 6 * 3, sensable.GetLinearOffset(vector<int>{ 1, 2, 3 }));
+				Assert::AreEqual(23.0f, sensable.Sense(vector<int>{ 1, 2, 3 }));
+
+				vector<int>   offsets{ 0, 5, 23 };
+				vector<vType> results(offsets.size());
+				sensor.SenseBatch(offsets.data(), (int)offsets.size(), results.data());
+
+				for (unsigned x = 0; x < offsets.size(); ++x)
+					Assert::AreEqual((vType)data[offsets[x]] / (vType)100.0f, results[x]);
+			}
+
+			remove(path.c_str());
+		}
+
+		TEST_METHOD(t_MappedSensable_Validation)
+			// Opening a file with the wrong element type, or a shape larger than the file, throws.
+		{
+			const string path{ "t_MappedSensable_Validation.nsns" };
+
+			vector<uint8_t> data{ 1, 2, 3, 4 };
+			WriteSensableFile(path, vector<int>{ 4 }, data.data());
+
+			bool wrongTypeThrew = false;
+			try { MappedSensable<int32_t>::Open(path); }
+			catch (const char*) { wrongTypeThrew = true; }
+
+			bool tooShortThrew = false;
+			try { MappedSensable<uint8_t> sensable{ path, vector<int>{ 64 } }; }
+			catch (const char*) { tooShortThrew = true; }
+
+			remove(path.c_str());
+
+			Assert::IsTrue(wrongTypeThrew);
+			Assert::IsTrue(tooShortThrew);
+		}
+
+		TEST_METHOD(t_MappedSensable_CorruptHeader)
+			// A header whose shape overflows the element count, or whose data offset lies past the
+			// end of the file, throws instead of passing the truncation check.
+		{
+			const string path{ "t_MappedSensable_CorruptHeader.nsns" };
+
+			auto opens = [&path](const nSensableFileHeader& header) {
+				{
+					ofstream out(path, ios::binary);
+					out.write((const char*)&header, sizeof(header));
+					out.write("data", 4);
+				}
+				bool opened = true;
+				try { MappedSensable<uint8_t>::Open(path); }
+				catch (const char*) { opened = false; }
+				remove(path.c_str());
+				return opened;
+			};
+
+			nSensableFileHeader header{};
+			memcpy(header.Magic, "nSNS", 4);
+			header.Version        = SENSABLE_FILE_VERSION;
+			header.ElementType    = (uint8_t)nElementType::U8;
+			header.DimensionCount = 1;
+			header.Lengths[0]     = 4;
+			header.DataOffset     = sizeof(header);
+			Assert::IsTrue(opens(header));
+
+			nSensableFileHeader overflow = header;
+			overflow.DimensionCount = 3;
+			overflow.Lengths[0] = overflow.Lengths[1] = overflow.Lengths[2] = 1u << 22;
+			Assert::IsFalse(opens(overflow));
+
+			nSensableFileHeader pastEnd = header;
+			pastEnd.DataOffset = 4096;
+			Assert::IsFalse(opens(pastEnd));
+		}
+	};
+}
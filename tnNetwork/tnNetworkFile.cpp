@@ -0,0 +1,132 @@
+#include "CppUnitTest.h"
+#include "../nNetworkImplementation/NetworkFile.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tNetworkFile)
+	{
+	public:
+		TEST_METHOD(t_NetworkFile_RoundTrip)
+			// Save a ticked network, load it again and make sure both networks are identical and
+			// stay identical while they tick.
+		{
+			const string path{ "t_NetworkFile_RoundTrip.nnet" };
+
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.3,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation % 11}; }
+			};
+
+			auto pNetwork = make_unique<nNodeNetwork>(vector<int>{16, 8, 4, 1}, *pStringSensor, Config);
+			for (int x = 0; x < 25; ++x)
+				pNetwork->Tick();
+
+			WriteNetworkFile(path, *pNetwork);
+
+			{
+				auto pLoaded = ReadNetworkFile(path, *pStringSensor, Config);
+
+				Assert::IsTrue(pNetwork->GetLayerCounts() == pLoaded->GetLayerCounts());
+				Assert::AreEqual(pNetwork->GetSynapseCount(), pLoaded->GetSynapseCount());
+
+				for (int tick = 0; tick < 25; ++tick) {
+					pNetwork->ForEach([&pLoaded](const nNode& node) {
+						auto loaded = pLoaded->GetNodeByNetworkId(node.GetNetworkId());
+						Assert::AreEqual(node.GetCurrentValue(), loaded.GetCurrentValue());
+						Assert::AreEqual(node.GetDecay(), loaded.GetDecay());
+						Assert::AreEqual(node.GetRestCount(), loaded.GetRestCount());
+						Assert::AreEqual(node.GetMaxRestCount(), loaded.GetMaxRestCount());
+
+						auto synapses       = node.GetSynapses();
+						auto loadedSynapses = loaded.GetSynapses();
+						Assert::AreEqual(synapses.size(), loadedSynapses.size());
+						for (unsigned x = 0; x < synapses.size(); ++x) {
+							Assert::AreEqual(synapses[x].weight, loadedSynapses[x].weight);
+							Assert::AreEqual(synapses[x].target, loadedSynapses[x].target);
+						}
+					});
+
+					pNetwork->Tick();
+					pLoaded->Tick();
+				}
+			}
+
+			remove(path.c_str());
+		}
+
+		TEST_METHOD(t_NetworkFile_Rejects)
+			// A truncated file and a file that is not a network file must both be rejected.
+		{
+			const string path{ "t_NetworkFile_Rejects.nnet" };
+
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			WriteNetworkFile(path, *pNetwork);
+
+			vector<char> bytes;
+			{
+				ifstream in(path, ios::binary);
+				bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+			}
+
+			auto Rejects = [&](const vector<char>& contents) {
+				{
+					ofstream out(path, ios::binary | ios::trunc);
+					out.write(contents.data(), contents.size());
+				}
+				try {
+					ReadNetworkFile(path, *pStringSensor, pNetwork->GetConfig());
+				}
+				catch (const char*) {
+					return true;
+				}
+				return false;
+			};
+
+			Assert::IsTrue(Rejects(vector<char>(bytes.begin(), bytes.end() - 8)));
+
+			vector<char> badMagic = bytes;
+			badMagic[0] = 'x';
+			Assert::IsTrue(Rejects(badMagic));
+
+			// Point the first synapse at a node that does not exist.
+			nNetworkFileHeader header;
+			memcpy(&header, bytes.data(), sizeof(header));
+			size_t targets = (sizeof(header) + header.LayerCount * 4 + 7) & ~(size_t)7;
+			targets = (targets + 2 * header.NodeCount * sizeof(vType) + 7) & ~(size_t)7;
+			targets = (targets + header.NodeCount * 4 + 7) & ~(size_t)7;
+			targets = (targets + header.NodeCount * 4 + 7) & ~(size_t)7;
+			targets = (targets + (header.NodeCount + 1) * 4 + 7) & ~(size_t)7;
+
+			vector<char> badTarget = bytes;
+			int32_t target = 1000;
+			memcpy(&badTarget[targets], &target, sizeof(target));
+			Assert::IsTrue(Rejects(badTarget));
+
+			remove(path.c_str());
+		}
+	};
+}
@@ -1,8 +1,11 @@
 #include "CppUnitTest.h"
 #include "../nNetwork/nNetwork.h"
 #include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include "../nNetworkImplementation/IntegeralSensing.h"
 #include <vector>
+#include <algorithm>
 #include <memory>
+#include <climits>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace std;
@@ -100,13 +103,91 @@ namespace tNetwork
 
 					Assert::AreEqual(sourceNode.GetCurrentValue(), node.GetCurrentValue());
 
-					for (unsigned x = 0; x < node.Synapses.size(); ++x) {
-						Assert::AreEqual(node.Synapses[x].weight, sourceNode.Synapses[x].weight);
+					auto synapses       = node.GetSynapses();
+					auto sourceSynapses = sourceNode.GetSynapses();
+
+					Assert::AreEqual(sourceSynapses.size(), synapses.size());
+
+					for (unsigned x = 0; x < synapses.size(); ++x) {
+						Assert::AreEqual(synapses[x].weight, sourceSynapses[x].weight);
 					}
 				}
 			);
 		}
 
+		TEST_METHOD(tNodeNetwork_GetSnapShot_Into)
+			// Snapshot a ticked network into an existing network. The destination must end up
+			// with the same values, decays and weights, also after a second snapshot into it.
+			// A destination with a different layout is rejected.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+			auto pDestination    = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			for (int x = 0; x < 10; ++x)
+				pNetwork->Tick();
+
+			pNetwork->GetSnapShot(*pDestination);
+			pNetwork->Tick();
+			pNetwork->GetSnapShot(*pDestination);
+
+			pNetwork->ForEach([&pDestination](const nNode& node) {
+				auto copy = pDestination->GetNodeByNetworkId(node.GetNetworkId());
+				Assert::AreEqual(node.GetCurrentValue(), copy.GetCurrentValue());
+				Assert::AreEqual(node.GetDecay(), copy.GetDecay());
+				Assert::AreEqual(node.GetRestCount(), copy.GetRestCount());
+
+				auto synapses     = node.GetSynapses();
+				auto copySynapses = copy.GetSynapses();
+				for (unsigned x = 0; x < synapses.size(); ++x)
+					Assert::AreEqual(synapses[x].weight, copySynapses[x].weight);
+			});
+
+			auto pOther = make_unique<nNodeNetwork>(vector<int>{5, 3, 1}, *pStringSensor);
+			bool thrown = false;
+			try {
+				pNetwork->GetSnapShot(*pOther);
+			}
+			catch (const char*) {
+				thrown = true;
+			}
+			Assert::IsTrue(thrown);
+		}
+
+		TEST_METHOD(tNodeNetwork_BulkAccess)
+			// The spans must match the per node accessors, and global ids must map back to
+			// network ids only for nodes of this network.
+		{
+			auto pStringSensable = make_unique<StringSensable>("Test String");
+			auto pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			auto pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+			auto pOther          = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			for (int x = 0; x < 10; ++x)
+				pNetwork->Tick();
+
+			auto values = pNetwork->GetCurrentValues();
+			auto decays = pNetwork->GetDecays();
+			auto rests  = pNetwork->GetRestCounts();
+
+			Assert::AreEqual(11, values.size());
+
+			pNetwork->ForEach([&](const nNode& node) {
+				int id = node.GetNetworkId();
+				Assert::AreEqual(node.GetCurrentValue(), values[id]);
+				Assert::AreEqual(node.GetDecay(), decays[id]);
+				Assert::AreEqual(node.GetRestCount(), rests[id]);
+
+				Assert::AreEqual(id, pNetwork->FindNetworkId(node.GetGlobalId()));
+				Assert::AreEqual(-1, pOther->FindNetworkId(node.GetGlobalId()));
+			});
+
+			auto layer = values.subspan(pNetwork->GetLayerBegin(1), pNetwork->GetLayerEnd(1) - pNetwork->GetLayerBegin(1));
+			Assert::AreEqual(3, layer.size());
+			Assert::AreEqual(values[5], layer[0]);
+		}
+
 		TEST_METHOD(tNodeNetwork_GetSensingNodes)
 			// Check to make sure that the m_pSensingNodes vector is populated after building
 			// the network
@@ -115,10 +196,9 @@ namespace tNetwork
 			auto pStringSensor = new StringSensor(pStringSensable);
 			auto pNetwork = new nNodeNetwork(vector<int>{5, 3, 2, 1}, *pStringSensor);
 
-			vector<nSensingNode*>* result = pNetwork->GetSensingNodes();
+			vector<nSensingNode> result = pNetwork->GetSensingNodes();
 
-			Assert::IsNotNull(result);
-			Assert::AreEqual(5, (int)result->size());
+			Assert::AreEqual(5, (int)result.size());
 
 		};
 
@@ -129,9 +209,10 @@ namespace tNetwork
 			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
 			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
 
-			nNode* pResult = pNetwork->GetResultNode();
+			nNode result = pNetwork->GetResultNode();
 
-			Assert::IsNotNull(pResult);
+			// The result node is the last node in the network.
+			Assert::AreEqual(10, result.GetNetworkId());
 		}
 
 		TEST_METHOD(tNodeNetwork_SingleNodeNetwork)
@@ -141,24 +222,15 @@ namespace tNetwork
 			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
 			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{1}, *pStringSensor);
 
-			nNode* pResultNode = pNetwork->GetResultNode();
-			
-			// Make sure we can get the result node.
-			Assert::IsNotNull(pResultNode);
-
-			vector<nSensingNode*>* pSensingNodes = pNetwork->GetSensingNodes();
-
-			// Make sure we can get the sensing nodes (just one node in this case).
-			Assert::IsNotNull(pSensingNodes);
+			nNode resultNode = pNetwork->GetResultNode();
 
-			// Should be a single node in pSensingNodes.
-			Assert::AreEqual(1, (int)pSensingNodes->size());
+			vector<nSensingNode> sensingNodes = pNetwork->GetSensingNodes();
 
-			// Make sure there is actually a node in pSensingNodes.
-			Assert::IsNotNull((*pSensingNodes)[0]);
+			// Should be a single node in sensingNodes.
+			Assert::AreEqual(1, (int)sensingNodes.size());
 
 			// The result node and the sensing node should be the same node.
-			Assert::AreEqual(reinterpret_cast<int>((*pSensingNodes)[0]), reinterpret_cast<int>(pResultNode));
+			Assert::AreEqual(sensingNodes[0].GetNetworkId(), resultNode.GetNetworkId());
 		}
 
 		TEST_METHOD(tNodeNetwork_SensingLayerSynapses)
@@ -176,39 +248,27 @@ namespace tNetwork
 			Assert::IsNotNull(pNetwork.get());
 
 			// Get the sensing layer
-			vector<nSensingNode*>* pSensingLayer = pNetwork->GetSensingNodes();
-
-			Assert::IsNotNull(pSensingLayer);
+			vector<nSensingNode> sensingLayer = pNetwork->GetSensingNodes();
 
 			// Get the layer above the sensing layer
-			vector<nNode*>* pNextLayer = pNetwork->GetLayer(1);
+			vector<nNode> nextLayer = pNetwork->GetLayer(1);
 
 			// Make sure we have the right layer, we are looking for the layer just after
 			// the sensing layer.
-			Assert::IsNotNull(pNextLayer);
-			Assert::AreEqual(3, (int)pNextLayer->size());
+			Assert::AreEqual(3, (int)nextLayer.size());
+
+			for (auto& sensingNode : sensingLayer) {
 
-			for (auto pSensingNode : *pSensingLayer) {
+				auto synapses = sensingNode.GetSynapses();
 
 				// Make sure the number of synapses in this node is correct (should be 3 since the layer
 				// above the sensing layer has 3 nodes.
-				Assert::AreEqual(3, (int)pSensingNode->Synapses.size());
-
-				// Using reinterprate_cast<int> to compare references
-				Assert::AreEqual(
-					reinterpret_cast<int>(pSensingNode->Synapses[0].pNode),
-					reinterpret_cast<int>((*pNextLayer)[0])
-				);
-
-				Assert::AreEqual(
-					reinterpret_cast<int>(pSensingNode->Synapses[1].pNode),
-					reinterpret_cast<int>((*pNextLayer)[1])
-				);
-
-				Assert::AreEqual(
-					reinterpret_cast<int>(pSensingNode->Synapses[2].pNode),
-					reinterpret_cast<int>((*pNextLayer)[2])
-				);
+				Assert::AreEqual(3, (int)synapses.size());
+
+				// Synapses refer to their target by network id.
+				Assert::AreEqual(synapses[0].target, nextLayer[0].GetNetworkId());
+				Assert::AreEqual(synapses[1].target, nextLayer[1].GetNetworkId());
+				Assert::AreEqual(synapses[2].target, nextLayer[2].GetNetworkId());
 			}
 
 		}
@@ -235,40 +295,29 @@ namespace tNetwork
 			Assert::IsNotNull(pNetwork.get());
 
 			// Get layer 1
-			vector<nNode*>* pLayer1 = pNetwork->GetLayer(1);
+			vector<nNode> layer1 = pNetwork->GetLayer(1);
 
 			// Make sure we have the right layer by checking the number of nodes in the layer.
-			Assert::IsNotNull(pLayer1);
-			Assert::AreEqual(4, (int)pLayer1->size());
+			Assert::AreEqual(4, (int)layer1.size());
 
 			// Get layer 2
-			vector<nNode*>* pLayer2 = pNetwork->GetLayer(2);
+			vector<nNode> layer2 = pNetwork->GetLayer(2);
 
 			// Make sure we have the right layer by checking the number of nodes in the layer.
-			Assert::IsNotNull(pLayer2);
-			Assert::AreEqual(3, (int)pLayer2->size());
+			Assert::AreEqual(3, (int)layer2.size());
+
+			for (auto& layer1Node : layer1) {
 
-			for (auto pLayer1Node : *pLayer1) {
+				auto synapses = layer1Node.GetSynapses();
 
 				// Make sure the number of synapses in this node is correct (should be 3 since the layer
 				// above the sensing layer has 3 nodes.
-				Assert::AreEqual(3, (int)pLayer1Node->Synapses.size());
-
-				// Using reinterprate_cast<int> to compare references
-				Assert::AreEqual(
-					reinterpret_cast<int>(pLayer1Node->Synapses[0].pNode),
-					reinterpret_cast<int>((*pLayer2)[0])
-				);
-
-				Assert::AreEqual(
-					reinterpret_cast<int>(pLayer1Node->Synapses[1].pNode),
-					reinterpret_cast<int>((*pLayer2)[1])
-				);
-
-				Assert::AreEqual(
-					reinterpret_cast<int>(pLayer1Node->Synapses[2].pNode),
-					reinterpret_cast<int>((*pLayer2)[2])
-				);
+				Assert::AreEqual(3, (int)synapses.size());
+
+				// Synapses refer to their target by network id.
+				Assert::AreEqual(synapses[0].target, layer2[0].GetNetworkId());
+				Assert::AreEqual(synapses[1].target, layer2[1].GetNetworkId());
+				Assert::AreEqual(synapses[2].target, layer2[2].GetNetworkId());
 			}
 
 		}
@@ -301,9 +350,9 @@ namespace tNetwork
 			{
 				pNetwork->Tick();
 
-				nNode* pNode = pNetwork->GetLayer(0)->at(0);
+				nNode node = pNetwork->GetLayer(0).at(0);
 
-				vType result = pNode->GetCurrentValue();
+				vType result = node.GetCurrentValue();
 
 				bool bres = result > 0;
 
@@ -316,6 +365,549 @@ namespace tNetwork
 			// number of ticks. (this could indicate a bug)
 			Assert::IsTrue(tickCount > 10);
 		}
+
+		TEST_METHOD(tnNodeNetwork_LayersAreContiguous)
+			// Nodes are stored layer by layer, so the network ids of each layer must form a
+			// contiguous range that starts where the previous layer ended. Global ids follow the
+			// same layout.
+		{
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			int expectedId = 0;
+
+			for (int layer = 0; layer < 4; ++layer) {
+				for (auto& node : pNetwork->GetLayer(layer)) {
+					Assert::AreEqual(expectedId++, node.GetNetworkId());
+
+					auto byGlobalId = pNetwork->GetNodeByGlobalId(node.GetGlobalId());
+					Assert::AreEqual(node.GetNetworkId(), byGlobalId.GetNetworkId());
+				}
+			}
+
+			Assert::AreEqual(11, expectedId);
+		}
+
+		TEST_METHOD(tnNodeNetwork_SynapseCount)
+			// Every node is connected to every node in the layer above it, and the result layer
+			// has no outgoing synapses.
+		{
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pStringSensor);
+
+			Assert::AreEqual(5 * 3 + 3 * 2 + 2 * 1, pNetwork->GetSynapseCount());
+
+			int total = 0;
+			pNetwork->ForEach([&total](const nNode& node) { total += (int)node.GetSynapses().size(); });
+
+			Assert::AreEqual(pNetwork->GetSynapseCount(), total);
+			Assert::AreEqual(0, (int)pNetwork->GetResultNode().GetSynapses().size());
+		}
+
+		TEST_METHOD(tnNodeNetwork_QueuedMatchesRecursive)
+			// Queued propagation must produce exactly the same node values as recursive
+			// propagation. Decay and rest counts are fixed by the config so that a snapshot
+			// of the network is an exact copy of it.
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.3,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.01,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 2,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation}; }
+			};
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			unique_ptr<nNodeNetwork>   pRecursive      = make_unique<nNodeNetwork>(vector<int>{8, 6, 4, 2, 1}, *pStringSensor, Config);
+			unique_ptr<nNodeNetwork>   pQueued         = pRecursive->GetSnapShot();
+
+			pRecursive->SetPropagationMode(nPropagationMode::Recursive);
+			pQueued->SetPropagationMode(nPropagationMode::Queued);
+
+			for (int tick = 0; tick < 200; ++tick) {
+				pRecursive->Tick();
+				pQueued->Tick();
+
+				pRecursive->ForEach([&pQueued](const nNode& node) {
+					auto queuedNode = pQueued->GetNodeByNetworkId(node.GetNetworkId());
+					Assert::AreEqual(node.GetCurrentValue(), queuedNode.GetCurrentValue());
+					Assert::AreEqual(node.GetRestCount(), queuedNode.GetRestCount());
+				});
+			}
+		}
+
+		TEST_METHOD(tnNodeNetwork_SenseGrid)
+			// Build the sense offsets of the sensing layer from a 2D grid descriptor instead of a
+			// location mapper. Six sensing nodes, two per row, sample every other column of a
+			// 4 x 3 input starting at x = 1.
+		{
+			vector<vector<int>> v = vector<vector<int>>
+			{
+				{ vector<int>{ 1, 2, 3, 4 } },
+				{ vector<int>{ 2, 5, 7, 2 } },
+				{ vector<int>{ 3, 6, 8, 3 } }
+			};
+
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.2,
+
+				/*MinInitialDecay*/ 0.1,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 3,
+				/*MaxResetCount*/ 3,
+
+				nullptr
+			};
+			Config.SenseGrid = nSenseGrid{ /*Dimensions*/ 2, /*Columns*/ 2, /*OriginX*/ 1, /*OriginY*/ 0, /*StrideX*/ 2, /*StrideY*/ 1 };
+
+			unique_ptr<IntegralSensable2d<int>> pSensable = make_unique<IntegralSensable2d<int>>(v);
+			unique_ptr<IntegralSensor<int>>     pSensor   = make_unique<IntegralSensor<int>>(pSensable.get(), 10);
+			unique_ptr<nNodeNetwork>            pNetwork  = make_unique<nNodeNetwork>(vector<int>{6, 2, 1}, *pSensor, Config);
+
+			vector<nSensingNode> sensingNodes = pNetwork->GetSensingNodes();
+			vector<int> expectedOffsets{ 1, 3, 5, 7, 9, 11 };
+
+			Assert::AreEqual(6, (int)sensingNodes.size());
+			for (int x = 0; x < 6; ++x)
+				Assert::AreEqual(expectedOffsets[x], sensingNodes[x].GetSenseOffset());
+
+			// The first tick senses 2, 4, 5, 2, 6 and 3 tenths, none of which fire.
+			pNetwork->Tick();
+			Assert::AreEqual(0.5 - sensingNodes[2].GetDecay(), sensingNodes[2].GetCurrentValue());
+		}
+
+		TEST_METHOD(tnNodeNetwork_SenseWithoutOffsets)
+			// A sensor that only implements Sense has no linear offsets, its sensing nodes are
+			// sensed through their locations and tick as those of a sensor with offsets.
+		{
+			class LocationSensor : public ISensor {
+			public:
+				LocationSensor(const ISensor* pSensor) : m_pSensor{ pSensor } {}
+				virtual vType Sense(const vector<int>& senseLocation) const override { return m_pSensor->Sense(senseLocation); }
+			private:
+				const ISensor* m_pSensor;
+			};
+
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{ nodeLocation }; }
+			};
+			Config.Seed = 17;
+
+			unique_ptr<StringSensable> pSensable       = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pSensor         = make_unique<StringSensor>(pSensable.get());
+			unique_ptr<LocationSensor> pLocationSensor = make_unique<LocationSensor>(pSensor.get());
+
+			nNodeNetwork network{ vector<int>{ 5, 3, 2, 1 }, *pSensor, Config };
+			nNodeNetwork locationNetwork{ vector<int>{ 5, 3, 2, 1 }, *pLocationSensor, Config };
+
+			for (nSensingNode node : locationNetwork.GetSensingNodes())
+				Assert::AreEqual(-1, node.GetSenseOffset());
+
+			for (int tick = 0; tick < 50; ++tick) {
+				network.Tick();
+				locationNetwork.Tick();
+			}
+
+			for (int x = 0; x < network.GetNodeCount(); ++x) {
+				Assert::AreEqual(network.GetCurrentValues()[x], locationNetwork.GetCurrentValues()[x]);
+				Assert::AreEqual(network.GetRestCounts()[x], locationNetwork.GetRestCounts()[x]);
+			}
+		}
+
+		TEST_METHOD(tnNodeNetwork_ParallelTickMatchesSerial)
+			// A network ticked on a thread pool must end up bit for bit identical to the same
+			// network ticked serially. Both networks are built from the same seed, the second one on
+			// the pool, and a tiny chunk size forces plenty of chunks and stealing.
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.3,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation % 11}; }
+			};
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			Config.Seed = 1234;
+			unique_ptr<nNodeNetwork> pSerial = make_unique<nNodeNetwork>(vector<int>{64, 16, 8, 1}, *pStringSensor, Config);
+
+			Config.TickThreadCount = 4;
+			Config.TickChunkSize   = 5;
+
+			unique_ptr<nNodeNetwork> pParallel = make_unique<nNodeNetwork>(vector<int>{64, 16, 8, 1}, *pStringSensor, Config);
+
+			for (int tick = 0; tick < 100; ++tick) {
+				pSerial->Tick();
+				pParallel->Tick();
+			}
+
+			pSerial->ForEach([&pParallel](const nNode& node) {
+				auto parallelNode = pParallel->GetNodeByNetworkId(node.GetNetworkId());
+				Assert::AreEqual(node.GetCurrentValue(), parallelNode.GetCurrentValue());
+				Assert::AreEqual(node.GetRestCount(), parallelNode.GetRestCount());
+			});
+		}
+
+		TEST_METHOD(tnNodeNetwork_SynchronousDelaysSpikes)
+			// A synchronous spike reaches the next layer one tick after it fires.
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.5,
+				/*MaxInitialSynapseWeight*/ 0.5,
+
+				/*MinInitialDecay*/ 0.125,
+				/*MaxInitialDecay*/ 0.125,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 1,
+
+				[](int nodeLocation) { return vector<int>{0}; }
+			};
+			Config.PropagationMode = nPropagationMode::Synchronous;
+
+			// Sensing '\xff' gives 1.0, so the sensing node fires on every tick.
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("\xff");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			unique_ptr<nNodeNetwork> pNetwork = make_unique<nNodeNetwork>(vector<int>{1, 1}, *pStringSensor, Config);
+
+			pNetwork->Tick();
+			Assert::AreEqual(0.0, pNetwork->GetNodeByNetworkId(1).GetCurrentValue());
+
+			pNetwork->Tick();
+			Assert::AreEqual(0.375, pNetwork->GetNodeByNetworkId(1).GetCurrentValue());
+		}
+
+		TEST_METHOD(tnNodeNetwork_SynchronousIsReproducible)
+			// Synchronous networks must come out bit for bit identical whatever the thread count
+			// and chunk size.
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.4,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation % 11}; }
+			};
+			Config.PropagationMode = nPropagationMode::Synchronous;
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			Config.Seed = 4321;
+			unique_ptr<nNodeNetwork> pSerial = make_unique<nNodeNetwork>(vector<int>{64, 16, 8, 1}, *pStringSensor, Config);
+
+			Config.TickThreadCount = 4;
+			Config.TickChunkSize   = 3;
+
+			unique_ptr<nNodeNetwork> pParallel = make_unique<nNodeNetwork>(vector<int>{64, 16, 8, 1}, *pStringSensor, Config);
+
+			for (int tick = 0; tick < 100; ++tick) {
+				pSerial->Tick();
+				pParallel->Tick();
+			}
+
+			pSerial->ForEach([&pParallel](const nNode& node) {
+				auto parallelNode = pParallel->GetNodeByNetworkId(node.GetNetworkId());
+				Assert::AreEqual(node.GetCurrentValue(), parallelNode.GetCurrentValue());
+				Assert::AreEqual(node.GetRestCount(), parallelNode.GetRestCount());
+			});
+		}
+
+		static nNodeNetworkConfig GetSparseConfig()
+		{
+			return nNodeNetworkConfig{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.2,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation % 11}; }
+			};
+		}
+
+		TEST_METHOD(tnNodeNetwork_FixedFanOut)
+			// Every node of the lower layers gets exactly FanOut distinct targets, sorted, in the
+			// layer above. A layer smaller than FanOut is connected fully.
+		{
+			nNodeNetworkConfig Config = GetSparseConfig();
+			Config.Connectivity = nConnectivityProfile{ nConnectivity::FixedFanOut, /*FanOut*/ 5 };
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{40, 20, 3, 1}, *pStringSensor, Config);
+
+			Assert::AreEqual(40 * 5 + 20 * 3 + 3 * 1, pNetwork->GetSynapseCount());
+
+			pNetwork->ForEach([&pNetwork](const nNode& node) {
+				int layer = node.GetNetworkId() < 40 ? 0 : node.GetNetworkId() < 60 ? 1 : node.GetNetworkId() < 63 ? 2 : 3;
+				nSynapseView synapses = node.GetSynapses();
+
+				for (size_t x = 0; x < synapses.size(); ++x) {
+					Assert::IsTrue(synapses[x].target >= pNetwork->GetLayerBegin(layer + 1));
+					Assert::IsTrue(synapses[x].target <  pNetwork->GetLayerEnd(layer + 1));
+					if (x) Assert::IsTrue(synapses[x - 1].target < synapses[x].target);
+				}
+			});
+		}
+
+		TEST_METHOD(tnNodeNetwork_ProbabilityConnectivity)
+			// About Probability of the possible synapses exist.
+		{
+			nNodeNetworkConfig Config = GetSparseConfig();
+			Config.Connectivity.Type        = nConnectivity::Probability;
+			Config.Connectivity.Probability = 0.25;
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			Config.Seed = 77;
+			unique_ptr<nNodeNetwork> pNetwork = make_unique<nNodeNetwork>(vector<int>{200, 100, 1}, *pStringSensor, Config);
+
+			// 20000 + 100 possible synapses, the count is within 5 standard deviations.
+			int count = pNetwork->GetSynapseCount();
+			Assert::IsTrue(count > 5025 - 310 && count < 5025 + 310);
+
+			// A probability of 1 is a full connection.
+			Config.Connectivity.Probability = 1;
+			pNetwork = make_unique<nNodeNetwork>(vector<int>{20, 10, 1}, *pStringSensor, Config);
+			Assert::AreEqual(20 * 10 + 10, pNetwork->GetSynapseCount());
+		}
+
+		TEST_METHOD(tnNodeNetwork_ReceptiveField)
+			// A 4 x 4 sensing grid feeds a 2 x 2 layer through 3 x 3 receptive fields, the layer
+			// above that is connected fully.
+		{
+			vector<vector<int>> v(4, vector<int>{ 1, 2, 3, 4 });
+
+			nNodeNetworkConfig Config = GetSparseConfig();
+			Config.pSensorLocationMapper = nullptr;
+			Config.SenseGrid         = nSenseGrid{ /*Dimensions*/ 2, /*Columns*/ 4, /*OriginX*/ 0, /*OriginY*/ 0, /*StrideX*/ 1, /*StrideY*/ 1 };
+			Config.LayerConnectivity = { nConnectivityProfile{ nConnectivity::ReceptiveField, /*FanOut*/ 0, /*Probability*/ 0, /*FieldRadius*/ 1 } };
+
+			unique_ptr<IntegralSensable2d<int>> pSensable = make_unique<IntegralSensable2d<int>>(v);
+			unique_ptr<IntegralSensor<int>>     pSensor   = make_unique<IntegralSensor<int>>(pSensable.get(), 10);
+			unique_ptr<nNodeNetwork>            pNetwork  = make_unique<nNodeNetwork>(vector<int>{16, 4, 1}, *pSensor, Config);
+
+			vector<int> inputs(4, 0);
+			for (int x = 0; x < 16; ++x) {
+				nSynapseView synapses = pNetwork->GetNodeByNetworkId(x).GetSynapses();
+				for (size_t y = 0; y < synapses.size(); ++y)
+					++inputs[synapses[y].target - 16];
+			}
+
+			// The field of top node 0 is centred on (1, 1), the one of top node 3 on (3, 3) and
+			// clipped by the grid edge.
+			Assert::AreEqual(9, inputs[0]);
+			Assert::AreEqual(6, inputs[1]);
+			Assert::AreEqual(6, inputs[2]);
+			Assert::AreEqual(4, inputs[3]);
+			Assert::AreEqual(25 + 4, pNetwork->GetSynapseCount());
+
+			// Bottom node 10, at (2, 2), is in all four fields, node 5, at (1, 1), only in the first.
+			Assert::AreEqual(4, (int)pNetwork->GetNodeByNetworkId(10).GetSynapses().size());
+			Assert::AreEqual(1, (int)pNetwork->GetNodeByNetworkId(5).GetSynapses().size());
+		}
+
+		TEST_METHOD(tnNodeNetwork_LargeSparseBuild)
+			// Construction scales with the synapse count, not with the product of the layer sizes.
+		{
+			nNodeNetworkConfig Config = GetSparseConfig();
+			Config.Connectivity = nConnectivityProfile{ nConnectivity::FixedFanOut, /*FanOut*/ 8 };
+
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+			unique_ptr<nNodeNetwork>   pNetwork        = make_unique<nNodeNetwork>(vector<int>{100000, 100000, 1}, *pStringSensor, Config);
+
+			Assert::AreEqual(100000 * 8 + 100000, pNetwork->GetSynapseCount());
+		}
+
+		TEST_METHOD(tnNodeNetwork_SeedIsReproducible)
+			// The same seed builds the same network, serially or on a pool, for every
+			// connectivity. Networks without a seed get distinct ones.
+		{
+			unique_ptr<StringSensable> pStringSensable = make_unique<StringSensable>("Test String");
+			unique_ptr<StringSensor>   pStringSensor   = make_unique<StringSensor>(pStringSensable.get());
+
+			for (auto type : { nConnectivity::Full, nConnectivity::FixedFanOut, nConnectivity::Probability }) {
+				nNodeNetworkConfig Config = GetSparseConfig();
+				Config.Connectivity.Type = type;
+				Config.Seed              = 2024;
+
+				unique_ptr<nNodeNetwork> pSerial = make_unique<nNodeNetwork>(vector<int>{300, 100, 10, 1}, *pStringSensor, Config);
+
+				Config.TickThreadCount = 3;
+				Config.TickChunkSize   = 7;
+				unique_ptr<nNodeNetwork> pParallel = make_unique<nNodeNetwork>(vector<int>{300, 100, 10, 1}, *pStringSensor, Config);
+
+				vector<int> layerCounts;
+				nNetworkImage serial   = pSerial->GetImage(layerCounts);
+				nNetworkImage parallel = pParallel->GetImage(layerCounts);
+
+				Assert::AreEqual((uint64_t)2024, pParallel->GetSeed());
+				Assert::IsTrue(equal(serial.Decays.begin(), serial.Decays.end(), parallel.Decays.begin()));
+				Assert::IsTrue(equal(serial.MaxRestCounts.begin(), serial.MaxRestCounts.end(), parallel.MaxRestCounts.begin()));
+				Assert::AreEqual(serial.Targets.size(), parallel.Targets.size());
+				Assert::IsTrue(equal(serial.RowOffsets.begin(), serial.RowOffsets.end(), parallel.RowOffsets.begin()));
+				Assert::IsTrue(equal(serial.Targets.begin(), serial.Targets.end(), parallel.Targets.begin()));
+				Assert::IsTrue(equal(serial.Weights.begin(), serial.Weights.end(), parallel.Weights.begin()));
+
+				for (auto weight : serial.Weights)
+					Assert::IsTrue(weight >= Config.MinInitialSynapseWeight && weight < Config.MaxInitialSynapseWeight);
+			}
+
+			nNodeNetworkConfig Config = GetSparseConfig();
+			unique_ptr<nNodeNetwork> pFirst  = make_unique<nNodeNetwork>(vector<int>{5, 3, 1}, *pStringSensor, Config);
+			unique_ptr<nNodeNetwork> pSecond = make_unique<nNodeNetwork>(vector<int>{5, 3, 1}, *pStringSensor, Config);
+
+			Assert::IsTrue(pFirst->GetSeed() != 0);
+			Assert::IsTrue(pFirst->GetSeed() != pSecond->GetSeed());
+		}
+
+		TEST_METHOD(tnNodeNetwork_ValueTypes)
+			// Networks of every value type can be built from the same seed and ticked side by
+			// side. Their weights are the double weights rounded to the type, and with values,
+			// weights and decays on the fixed point grid the three networks tick identically.
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.25,
+				/*MaxInitialSynapseWeight*/ 0.75,
+
+				/*MinInitialDecay*/ 0.0625,
+				/*MaxInitialDecay*/ 0.0625,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				nullptr
+			};
+			Config.SenseGrid = nSenseGrid{ /*Dimensions*/ 2, /*Columns*/ 8, /*OriginX*/ 0, /*OriginY*/ 0, /*StrideX*/ 1, /*StrideY*/ 1 };
+			Config.Seed      = 21;
+
+			vector<vector<int>> v(1, vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+			unique_ptr<IntegralSensable2d<int>> pSensable = make_unique<IntegralSensable2d<int>>(v);
+			unique_ptr<IntegralSensor<int>>     pSensor   = make_unique<IntegralSensor<int>>(pSensable.get(), 16);
+
+			nNodeNetwork    network{ vector<int>{8, 6, 3, 1}, *pSensor, Config };
+			nNodeNetworkF32 networkF32{ vector<int>{8, 6, 3, 1}, *pSensor, Config };
+			nNodeNetworkQ16 networkQ16{ vector<int>{8, 6, 3, 1}, *pSensor, Config };
+
+			vector<int> layerCounts, layerCountsF32, layerCountsQ16;
+			auto image    = network.GetImage(layerCounts);
+			auto imageF32 = networkF32.GetImage(layerCountsF32);
+			auto imageQ16 = networkQ16.GetImage(layerCountsQ16);
+
+			Assert::AreEqual(image.Weights.size(), imageQ16.Weights.size());
+			for (int x = 0; x < image.Weights.size(); ++x) {
+				Assert::AreEqual((float)image.Weights[x], imageF32.Weights[x]);
+				Assert::AreEqual(nFixed16{ image.Weights[x] }.GetRaw(), imageQ16.Weights[x].GetRaw());
+			}
+
+			// Put the weights on the grid of nFixed16, which every type represents exactly.
+			vector<vType> weights(image.Weights.begin(), image.Weights.end());
+			vector<float> weightsF32(imageF32.Weights.begin(), imageF32.Weights.end());
+			for (int x = 0; x < (int)weights.size(); ++x) {
+				weights[x]    = (double)imageQ16.Weights[x];
+				weightsF32[x] = (float)imageQ16.Weights[x];
+			}
+			image.Weights    = { weights.data(), (int)weights.size() };
+			imageF32.Weights = { weightsF32.data(), (int)weightsF32.size() };
+
+			nNodeNetwork    exact{ image, *pSensor, Config };
+			nNodeNetworkF32 exactF32{ imageF32, *pSensor, Config };
+
+			for (int tick = 0; tick < 50; ++tick) {
+				exact.Tick();
+				exactF32.Tick();
+				networkQ16.Tick();
+
+				for (int x = 0; x < exact.GetNodeCount(); ++x) {
+					Assert::AreEqual(exact.GetCurrentValues()[x], (double)exactF32.GetCurrentValues()[x]);
+					Assert::AreEqual(exact.GetCurrentValues()[x], (double)networkQ16.GetCurrentValues()[x]);
+					Assert::AreEqual(exact.GetRestCounts()[x], networkQ16.GetRestCounts()[x]);
+				}
+			}
+		}
+
+		TEST_METHOD(tnNodeNetwork_ImageRejects)
+			// A network is only built from images whose arrays match their layer counts and whose
+			// synapses all lead to the next layer.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{ 5, 3, 2, 1 }, *pSensor);
+
+			vector<int>   layerCounts;
+			nNetworkImage image = pNetwork->GetImage(layerCounts);
+			nNodeNetwork  copy{ image, *pSensor, pNetwork->GetConfig() };
+
+			// Layer counts whose int sum wraps around to the two nodes of the arrays.
+			vector<int>   wrapCounts{ INT_MAX, INT_MAX, 4 };
+			vector<vType> values(2);
+			vector<int>   counts(2);
+			vector<int>   rowOffsets(3);
+
+			nNetworkImage wrap;
+			wrap.LayerCounts   = { wrapCounts.data(), (int)wrapCounts.size() };
+			wrap.CurrentValues = { values.data(), 2 };
+			wrap.Decays        = { values.data(), 2 };
+			wrap.RestCounts    = { counts.data(), 2 };
+			wrap.MaxRestCounts = { counts.data(), 2 };
+			wrap.RowOffsets    = { rowOffsets.data(), 3 };
+
+			Assert::ExpectException<const char*>([&]() { nNodeNetwork network{ wrap, *pSensor, pNetwork->GetConfig() }; });
+
+			// Synapses into the sensing layer, back along the layers, into the same layer, onto
+			// their own source and past the next layer.
+			int sensing = 0;
+			int middle  = pNetwork->GetLayerBegin(1);
+			int top     = pNetwork->GetLayerBegin(2);
+
+			for (auto bad : vector<pair<int, int>>{ { middle, sensing }, { top, middle }, { middle, middle + 1 }, { middle, middle }, { sensing, top } }) {
+				vector<int> targets(image.Targets.begin(), image.Targets.end());
+				targets[image.RowOffsets[bad.first]] = bad.second;
+
+				nNetworkImage edge = image;
+				edge.Targets = { targets.data(), (int)targets.size() };
+
+				Assert::ExpectException<const char*>([&]() { nNodeNetwork network{ edge, *pSensor, pNetwork->GetConfig() }; });
+			}
+		}
 	};
 	
 	
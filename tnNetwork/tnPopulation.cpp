@@ -0,0 +1,143 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetwork/nPopulation.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tPopulation)
+	{
+	public:
+		static nNodeNetworkConfig GetConfig()
+		{
+			nNodeNetworkConfig config{
+				/*MinInitialSynapseWeight*/ 0.2,
+				/*MaxInitialSynapseWeight*/ 0.5,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 1,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation % 8}; }
+			};
+			config.PropagationMode = nPropagationMode::Synchronous;
+			return config;
+		}
+
+		TEST_METHOD(tPopulation_MatchesNetworks)
+			// Every member of a population must tick exactly like the synchronous nNodeNetwork
+			// it was generated as, serially and on a thread pool.
+		{
+			vector<unique_ptr<StringSensable>> sensables;
+			vector<unique_ptr<StringSensor>>   sensors;
+			vector<const ISensor*>             pSensors;
+
+			for (auto text : { "Test String", "Another one", "ABCDEFGH", "\xff\xff\xff\xff\xff\xff\xff\xff", "zz", "nNetwork" }) {
+				sensables.push_back(make_unique<StringSensable>(text));
+				sensors.push_back(make_unique<StringSensor>(sensables.back().get()));
+				pSensors.push_back(sensors.back().get());
+			}
+
+			for (int threads : { 1, 3 }) {
+				nNodeNetworkConfig config = GetConfig();
+				config.TickThreadCount = threads;
+				config.TickChunkSize   = 7;
+
+				vector<unique_ptr<nNodeNetwork>> networks;
+				for (int member = 0; member < (int)pSensors.size(); ++member) {
+					config.Seed = 99 + member;
+					networks.push_back(make_unique<nNodeNetwork>(vector<int>{8, 5, 3, 1}, *pSensors[member], config));
+				}
+
+				// The members are only built to be packed, nothing is taken from a caller's arena.
+				nArena arena;
+				config.Seed   = 99;
+				config.pArena = &arena;
+				nPopulation population{ vector<int>{8, 5, 3, 1}, pSensors, config };
+
+				Assert::AreEqual((int)pSensors.size(), population.GetMemberCount());
+				Assert::AreEqual((size_t)0, arena.GetUsedSize());
+
+				for (int tick = 0; tick < 60; ++tick) {
+					population.Tick();
+					for (auto& pNetwork : networks)
+						pNetwork->Tick();
+				}
+
+				for (int member = 0; member < population.GetMemberCount(); ++member) {
+					networks[member]->ForEach([&population, member](const nNode& node) {
+						Assert::AreEqual(node.GetCurrentValue(), population.GetCurrentValue(member, node.GetNetworkId()));
+						Assert::AreEqual(node.GetRestCount(), population.GetRestCount(member, node.GetNetworkId()));
+					});
+				}
+			}
+		}
+
+		TEST_METHOD(tPopulation_GetMember)
+			// An unpacked member carries on exactly where the population left it.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			nPopulation population{ vector<int>{8, 5, 3, 1}, vector<const ISensor*>(4, pSensor.get()), GetConfig() };
+
+			population.SetWeight(2, 0, 0.75);
+			for (int tick = 0; tick < 20; ++tick)
+				population.Tick();
+
+			auto pMember = population.GetMember(2);
+			Assert::AreEqual(0.75, pMember->GetNodeByNetworkId(0).GetSynapses()[0].weight);
+
+			for (int tick = 0; tick < 20; ++tick) {
+				population.Tick();
+				pMember->Tick();
+			}
+
+			pMember->ForEach([&population](const nNode& node) {
+				Assert::AreEqual(node.GetCurrentValue(), population.GetCurrentValue(2, node.GetNetworkId()));
+			});
+		}
+
+		TEST_METHOD(tPopulation_TickCost)
+			// Benchmark: 256 {5, 3, 2, 1} networks ticked one by one, and as one population.
+			// Only logs, the numbers depend on the machine.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			const int members = 256;
+			const int ticks   = 200;
+
+			vector<unique_ptr<nNodeNetwork>> networks;
+			for (int x = 0; x < members; ++x)
+				networks.push_back(make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pSensor, GetConfig()));
+
+			nPopulation population{ vector<int>{5, 3, 2, 1}, vector<const ISensor*>(members, pSensor.get()), GetConfig() };
+
+			auto start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				for (auto& pNetwork : networks)
+					pNetwork->Tick();
+			chrono::duration<double> separate = chrono::steady_clock::now() - start;
+
+			start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				population.Tick();
+			chrono::duration<double> packed = chrono::steady_clock::now() - start;
+
+			string message = "separate: " + to_string(separate.count() * 1e9 / (ticks * members)) + " ns, population: " +
+				to_string(packed.count() * 1e9 / (ticks * members)) + " ns per network tick";
+			Logger::WriteMessage(message.c_str());
+		}
+	};
+}
@@ -0,0 +1,167 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetwork/nStaticNetwork.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tStaticNetwork)
+	{
+	public:
+		static nNodeNetworkConfig GetConfig()
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{nodeLocation}; }
+			};
+			Config.PropagationMode = nPropagationMode::Queued;
+			Config.Seed            = 5321;
+			return Config;
+		}
+
+		template <int... Layers>
+		static void AssertTicksAsDynamic(const nNodeNetwork& dynamic, nStaticNetwork<Layers...>& fixed)
+		{
+			for (int x = 0; x < dynamic.GetNodeCount(); ++x) {
+				Assert::AreEqual(dynamic.GetNodeByNetworkId(x).GetCurrentValue(), fixed.GetCurrentValue(x));
+				Assert::AreEqual(dynamic.GetNodeByNetworkId(x).GetRestCount(), fixed.GetRestCount(x));
+			}
+		}
+
+		TEST_METHOD(tStaticNetwork_TicksAsDynamic)
+			// A static network imported from a {5, 3, 2, 1} network ticks bit for bit as the
+			// network does.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pSensor, GetConfig());
+
+			for (int tick = 0; tick < 7; ++tick)
+				pNetwork->Tick();
+
+			nStaticNetwork<5, 3, 2, 1> fixed{ *pNetwork };
+			AssertTicksAsDynamic(*pNetwork, fixed);
+
+			int resultFires = 0;
+			for (int tick = 0; tick < 1000; ++tick) {
+				pNetwork->Tick();
+				fixed.Tick();
+				AssertTicksAsDynamic(*pNetwork, fixed);
+
+				if (fixed.GetRestCount(10))
+					++resultFires;
+			}
+
+			Assert::AreEqual(pNetwork->GetCurrentValue(), fixed.GetResultValue());
+			Assert::IsTrue(resultFires > 0);
+		}
+
+		TEST_METHOD(tStaticNetwork_SparseTicksAsDynamic)
+			// Missing synapses are weights of 0 in the static network and change nothing.
+		{
+			nNodeNetworkConfig Config = GetConfig();
+			Config.Connectivity = nConnectivityProfile{ nConnectivity::FixedFanOut, /*FanOut*/ 2 };
+
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{8, 4, 3, 1}, *pSensor, Config);
+
+			nStaticNetwork<8, 4, 3, 1> fixed{ *pNetwork };
+
+			for (int tick = 0; tick < 1000; ++tick) {
+				pNetwork->Tick();
+				fixed.Tick();
+				AssertTicksAsDynamic(*pNetwork, fixed);
+			}
+		}
+
+		TEST_METHOD(tStaticNetwork_ImportChecksTriggerValues)
+			// A node above the trigger point would fire on the weight 0 of a missing synapse, a
+			// state holding one is refused. A node at the trigger point does not fire and ticks as
+			// the dynamic network does.
+		{
+			nNodeNetworkConfig Config = GetConfig();
+			Config.Connectivity = nConnectivityProfile{ nConnectivity::FixedFanOut, /*FanOut*/ 2 };
+
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{8, 4, 3, 1}, *pSensor, Config);
+
+			nNetworkState state;
+			pNetwork->GetState(state);
+			for (int x = 8; x < 12; ++x)
+				state.RestCounts[x] = 0;
+
+			state.CurrentValues[9] = 1.0;
+			pNetwork->SetState(state);
+			Assert::ExpectException<const char*>([&pNetwork]() { nStaticNetwork<8, 4, 3, 1> fixed{ *pNetwork }; });
+
+			state.CurrentValues[9] = NODE_TRIGGER_POINT;
+			pNetwork->SetState(state);
+			nStaticNetwork<8, 4, 3, 1> fixed{ *pNetwork };
+
+			for (int tick = 0; tick < 200; ++tick) {
+				pNetwork->Tick();
+				fixed.Tick();
+				AssertTicksAsDynamic(*pNetwork, fixed);
+			}
+		}
+
+		TEST_METHOD(tStaticNetwork_ImportChecksShape)
+			// A network with other layer counts, or with synchronous propagation, is refused.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pSensor, GetConfig());
+
+			Assert::ExpectException<const char*>([&pNetwork]() { nStaticNetwork<5, 3, 1> fixed{ *pNetwork }; });
+			Assert::ExpectException<const char*>([&pNetwork]() { nStaticNetwork<5, 3, 2, 2> fixed{ *pNetwork }; });
+
+			pNetwork->SetPropagationMode(nPropagationMode::Synchronous);
+			Assert::ExpectException<const char*>([&pNetwork]() { nStaticNetwork<5, 3, 2, 1> fixed{ *pNetwork }; });
+		}
+
+		TEST_METHOD(tStaticNetwork_TickCost)
+			// Benchmark: ticks per microsecond of a {5, 3, 2, 1} network, dynamic and static.
+			// Only logs, the numbers depend on the machine.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			auto pNetwork  = make_unique<nNodeNetwork>(vector<int>{5, 3, 2, 1}, *pSensor, GetConfig());
+
+			nStaticNetwork<5, 3, 2, 1> fixed{ *pNetwork };
+
+			const int ticks = 100000;
+
+			auto start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				pNetwork->Tick();
+			chrono::duration<double, micro> dynamic = chrono::steady_clock::now() - start;
+
+			start = chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; ++tick)
+				fixed.Tick();
+			chrono::duration<double, micro> fixedElapsed = chrono::steady_clock::now() - start;
+
+			string message = "dynamic: " + to_string(ticks / dynamic.count()) + ", static: " +
+				to_string(ticks / fixedElapsed.count()) + " ticks per microsecond";
+			Logger::WriteMessage(message.c_str());
+		}
+	};
+}
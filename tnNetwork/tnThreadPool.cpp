@@ -0,0 +1,82 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetwork/nThreadPool.h"
+#include "../nNetworkImplementation/IntegeralSensing.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tThreadPool)
+	{
+	public:
+		TEST_METHOD(tThreadPool_ParallelForCoversEveryIndex)
+			// Every index must be visited exactly once, whatever the thread count and the chunk
+			// size, and the pool must be reusable across calls.
+		{
+			for (int threads : { 1, 2, 4, 7 }) {
+				nThreadPool pool{ threads };
+				Assert::AreEqual(threads, pool.GetThreadCount());
+
+				for (int chunkSize : { 1, 3, 64, 5000 }) {
+					const int count = 1000;
+					vector<atomic<int>> visits(count);
+
+					pool.ParallelFor(count, chunkSize, [&visits](int begin, int end) {
+						for (int x = begin; x < end; ++x)
+							visits[x].fetch_add(1);
+					});
+
+					for (int x = 0; x < count; ++x)
+						Assert::AreEqual(1, visits[x].load());
+				}
+			}
+		}
+
+		TEST_METHOD(tThreadPool_TickScaling)
+			// Benchmark: ticks per second of a network with a 200k node sensing layer, from 1
+			// thread up to every hardware thread. Only logs, the numbers depend on the machine.
+		{
+			vector<int> input(200000);
+			for (int x = 0; x < (int)input.size(); ++x)
+				input[x] = x % 100;
+
+			IntegralSensable1d<int> sensable{ input };
+			IntegralSensor<int>     sensor{ &sensable, 1000 };
+
+			int maxThreads = (int)thread::hardware_concurrency();
+			if (maxThreads < 1)
+				maxThreads = 1;
+
+			// 1, 2, 4, ... and finally every hardware thread.
+			vector<int> threadCounts;
+			for (int threads = 1; threads < maxThreads; threads *= 2)
+				threadCounts.push_back(threads);
+			threadCounts.push_back(maxThreads);
+
+			for (int threads : threadCounts) {
+				nNodeNetworkConfig config{ 0.1, 0.2, 0.01, 0.02, 1, 3, [](int nodeLocation) { return vector<int>{nodeLocation}; } };
+				config.TickThreadCount = threads;
+				config.TickChunkSize   = 8192;
+
+				nNodeNetwork network{ vector<int>{ (int)input.size(), 4, 1 }, sensor, config };
+
+				const int ticks = 50;
+				auto start = chrono::steady_clock::now();
+				for (int x = 0; x < ticks; ++x)
+					network.Tick();
+				chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+				string message = to_string(threads) + " thread(s): " + to_string((int)(ticks / elapsed.count())) + " ticks/s";
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+	};
+}
@@ -0,0 +1,71 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nTickKernels.h"
+#include <vector>
+#include <random>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tTickKernels)
+	{
+	public:
+		TEST_METHOD(tTickKernels_MatchScalar)
+			// Every supported kernel must produce bit for bit the same values and rest counts as
+			// the scalar kernel. The node count is not a multiple of any vector width, so the
+			// scalar tail is exercised as well.
+		{
+			const int count = 1037;
+
+			mt19937 generator{ 42 };
+			uniform_real_distribution<double> valueDistribution{ -0.1, 1.0 };
+			uniform_real_distribution<double> decayDistribution{ 0.0, 0.2 };
+			uniform_int_distribution<int>     restDistribution{ 0, 3 };
+
+			vector<vType> values(count);
+			vector<vType> decays(count);
+			vector<int>   restCounts(count);
+
+			for (int x = 0; x < count; ++x) {
+				values[x]     = valueDistribution(generator);
+				decays[x]     = decayDistribution(generator);
+				restCounts[x] = restDistribution(generator);
+			}
+
+			// Edge cases: a value that decays to exactly 0, values that go negative and a
+			// value that is already -0.0.
+			values[0] = 0.25; decays[0] = 0.25;
+			values[1] = 0.0;  decays[1] = 0.1;
+			values[2] = -0.0; decays[2] = 0.0;
+
+			for (auto isa : { nTickIsa::SSE2, nTickIsa::AVX2, nTickIsa::AVX512 }) {
+				if (!IsTickIsaSupported(isa))
+					continue;
+
+				vector<vType> expectedValues     = values;
+				vector<int>   expectedRestCounts = restCounts;
+				vector<vType> actualValues       = values;
+				vector<int>   actualRestCounts   = restCounts;
+
+				// Several ticks, so that the rest counts reach 0 and stay there.
+				for (int tick = 0; tick < 5; ++tick) {
+					GetTickKernel(nTickIsa::Scalar)(expectedValues.data(), decays.data(), expectedRestCounts.data(), count);
+					GetTickKernel(isa)(actualValues.data(), decays.data(), actualRestCounts.data(), count);
+				}
+
+				Assert::AreEqual(0, memcmp(expectedValues.data(), actualValues.data(), count * sizeof(vType)));
+				Assert::AreEqual(0, memcmp(expectedRestCounts.data(), actualRestCounts.data(), count * sizeof(int)));
+			}
+		}
+
+		TEST_METHOD(tTickKernels_BestIsaIsSupported)
+		{
+			Assert::IsTrue(IsTickIsaSupported(GetBestTickIsa()));
+			Assert::IsTrue(IsTickIsaSupported(nTickIsa::Scalar));
+			Assert::IsTrue(GetTickKernel() == GetTickKernel(GetBestTickIsa()));
+		}
+	};
+}
@@ -0,0 +1,177 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nNetwork.h"
+#include "../nNetworkImplementation/nNetworkStringImplementation.h"
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+#if N_TICK_METRICS
+
+namespace tNetwork
+{
+	TEST_CLASS(tTickMetrics)
+	{
+	public:
+		static nNodeNetworkConfig GetConfig()
+		{
+			nNodeNetworkConfig Config{
+				/*MinInitialSynapseWeight*/ 0.1,
+				/*MaxInitialSynapseWeight*/ 0.6,
+
+				/*MinInitialDecay*/ 0.01,
+				/*MaxInitialDecay*/ 0.05,
+
+				/*MinResetCount*/ 2,
+				/*MaxResetCount*/ 4,
+
+				[](int nodeLocation) { return vector<int>{ nodeLocation }; }
+			};
+			Config.Seed               = 4242;
+			Config.CollectTickMetrics = true;
+			return Config;
+		}
+
+		// The activations delivered by the nodes of a {5, 3, 2, 1} network that fired during the
+		// last tick: each delivers one to every node of the next layer. A node above the sensing
+		// layer that fired rests with its max rest count minus the one it lost to the decay pass,
+		// the sensing nodes that fired are the rest of fired.
+		static uint64_t GetFiredActivations(const nNodeNetwork& network, uint64_t fired)
+		{
+			int layerFired[4] = { 0, 0, 0, 0 };
+			for (int x = network.GetLayerBegin(1); x < network.GetNodeCount(); ++x) {
+				if (network.GetRestCounts()[x] == network.GetMaxRestCounts()[x] - 1)
+					++layerFired[x < 8 ? 1 : x < 10 ? 2 : 3];
+			}
+			layerFired[0] = (int)fired - layerFired[1] - layerFired[2] - layerFired[3];
+
+			Assert::IsTrue(layerFired[0] >= 0 && layerFired[0] <= 5);
+			return 3 * layerFired[0] + 2 * layerFired[1] + layerFired[2];
+		}
+
+		TEST_METHOD(tTickMetrics_Disabled)
+			// Nothing is counted unless the config asks for it.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			nNodeNetworkConfig Config = GetConfig();
+			Config.CollectTickMetrics = false;
+			nNodeNetwork network{ vector<int>{ 5, 3, 2, 1 }, *pSensor, Config };
+
+			for (int tick = 0; tick < 20; ++tick)
+				network.Tick();
+
+			nTickMetrics lastTick, total;
+			network.GetTickMetrics(lastTick, total);
+			Assert::AreEqual((uint64_t)0, total.Ticks);
+			Assert::AreEqual((uint64_t)0, total.Activations);
+		}
+
+		TEST_METHOD(tTickMetrics_Queued)
+			// The nodes that fire during a tick deliver their activations during the same tick.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			nNodeNetwork network{ vector<int>{ 5, 3, 2, 1 }, *pSensor, GetConfig() };
+
+			nTickMetrics lastTick, total, sum;
+
+			for (int tick = 0; tick < 200; ++tick) {
+				network.Tick();
+				network.GetTickMetrics(lastTick, total);
+
+				Assert::AreEqual((uint64_t)1, lastTick.Ticks);
+				Assert::AreEqual(GetFiredActivations(network, lastTick.Fired), lastTick.Activations);
+				Assert::IsTrue(lastTick.AbsorbedActivations <= lastTick.Activations);
+
+				sum.Add(lastTick);
+			}
+
+			Assert::AreEqual((uint64_t)200, total.Ticks);
+			Assert::AreEqual(sum.Fired, total.Fired);
+			Assert::AreEqual(sum.Activations, total.Activations);
+			Assert::AreEqual(sum.AbsorbedActivations, total.AbsorbedActivations);
+			Assert::AreEqual(sum.DecayNanoseconds, total.DecayNanoseconds);
+			Assert::IsTrue(total.Fired > 0 && total.AbsorbedActivations > 0);
+			Assert::IsTrue(total.SenseNanoseconds + total.CascadeNanoseconds + total.DecayNanoseconds > 0);
+		}
+
+		TEST_METHOD(tTickMetrics_Synchronous)
+			// In synchronous mode the activations are the spikes of the previous tick.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+
+			nNodeNetworkConfig Config = GetConfig();
+			Config.PropagationMode = nPropagationMode::Synchronous;
+			nNodeNetwork network{ vector<int>{ 5, 3, 2, 1 }, *pSensor, Config };
+
+			nTickMetrics lastTick, total;
+			uint64_t     expected = 0;
+
+			for (int tick = 0; tick < 200; ++tick) {
+				network.Tick();
+				network.GetTickMetrics(lastTick, total);
+
+				Assert::AreEqual(expected, lastTick.Activations);
+
+				// The nodes fired during this tick deliver during the next one.
+				expected = GetFiredActivations(network, lastTick.Fired);
+			}
+
+			Assert::IsTrue(total.Fired > 0);
+		}
+
+		TEST_METHOD(tTickMetrics_ReadWhileTicking)
+			// A reader thread always sees the metrics of a single publication while another
+			// thread ticks the network.
+		{
+			auto pSensable = make_unique<StringSensable>("Test String");
+			auto pSensor   = make_unique<StringSensor>(pSensable.get());
+			nNodeNetwork network{ vector<int>{ 5, 3, 2, 1 }, *pSensor, GetConfig() };
+
+			atomic<bool> done{ false };
+			bool         consistent = true;
+			uint64_t     reads      = 0;
+
+			thread reader([&]() {
+				uint64_t previous = 0;
+				while (!done.load()) {
+					nTickMetrics lastTick, total;
+					network.GetTickMetrics(lastTick, total);
+
+					if (total.Ticks < previous || (total.Ticks && lastTick.Ticks != 1) || lastTick.Fired > total.Fired)
+						consistent = false;
+					previous = total.Ticks;
+					++reads;
+				}
+			});
+
+			for (int tick = 0; tick < 20000; ++tick)
+				network.Tick();
+
+			done = true;
+			reader.join();
+
+			nTickMetrics lastTick, total;
+			network.GetTickMetrics(lastTick, total);
+
+			Assert::IsTrue(consistent);
+			Assert::AreEqual((uint64_t)20000, total.Ticks);
+
+			string message = to_string(reads) + " reads, " + to_string(total.Fired) + " fired, " +
+				to_string(total.Activations) + " activations (" + to_string(total.AbsorbedActivations) + " absorbed), sense " +
+				to_string(total.SenseNanoseconds / total.Ticks) + " ns, cascade " + to_string(total.CascadeNanoseconds / total.Ticks) +
+				" ns, decay " + to_string(total.DecayNanoseconds / total.Ticks) + " ns per tick";
+			Logger::WriteMessage(message.c_str());
+		}
+	};
+}
+
+#endif
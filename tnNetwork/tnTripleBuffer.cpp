@@ -0,0 +1,66 @@
+#include "CppUnitTest.h"
+#include "../nNetwork/nTripleBuffer.h"
+#include <thread>
+#include <utility>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+using namespace nNetwork;
+
+namespace tNetwork
+{
+	TEST_CLASS(tTripleBuffer)
+	{
+	public:
+		TEST_METHOD(tTripleBuffer_AcquireLatest)
+		{
+			nTripleBuffer<int> buffer;
+
+			Assert::IsFalse(buffer.Acquire());
+
+			buffer.GetBack() = 1;
+			buffer.Publish();
+			buffer.GetBack() = 2;
+			buffer.Publish();
+
+			// Only the latest value is seen, and it stays put until the next Publish.
+			Assert::IsTrue(buffer.Acquire());
+			Assert::AreEqual(2, buffer.GetFront());
+			Assert::IsFalse(buffer.Acquire());
+			Assert::AreEqual(2, buffer.GetFront());
+
+			buffer.GetBack() = 3;
+			buffer.Publish();
+			Assert::IsTrue(buffer.Acquire());
+			Assert::AreEqual(3, buffer.GetFront());
+		}
+
+		TEST_METHOD(tTripleBuffer_NoTornReads)
+			// The writer keeps publishing pairs of equal values; the reader must never see a pair
+			// that is half written, and must never go back in time.
+		{
+			nTripleBuffer<pair<int, int>> buffer;
+			const int count = 200000;
+
+			thread writer([&buffer, count] {
+				for (int x = 1; x <= count; ++x) {
+					buffer.GetBack().first  = x;
+					buffer.GetBack().second = x;
+					buffer.Publish();
+				}
+			});
+
+			int last = 0;
+			while (last < count) {
+				if (!buffer.Acquire())
+					continue;
+				auto& value = buffer.GetFront();
+				Assert::AreEqual(value.first, value.second);
+				Assert::IsTrue(value.first > last);
+				last = value.first;
+			}
+
+			writer.join();
+		}
+	};
+}